@@ -0,0 +1,974 @@
+#include "memory_library.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __has_include(<fcntl.h>)
+#include <fcntl.h>
+#endif
+
+/*
+Runs every public function of memory_library.h over objects of 1, 2, 4, 8, 16, 64, 256 and 4096 bytes and the span
+overloads over a bulk array of 1 MiB, and reports for each the time per call, the bytes processed per TSC cycle and the
+heap allocations per call.
+
+	benchmark [--filter <text>] [--min-time <ms>] [--json <file>] [--baseline <file>]
+
+--filter    runs only the cases whose name contains <text>
+--min-time  measures each case for at least <ms> milliseconds (10 by default)
+--json      writes the results to <file>, one case per line
+--baseline  compares the results with a file written by --json and prints the speedup of each case
+*/
+
+// Every heap allocation of the process goes through these, so a case can tell how many allocations a call makes, over-aligned
+// ones included. The replacements are not inlined: GCC would otherwise see the std::free of operator delete applied to the result
+// of operator new at every call site and warn that they do not match (-Wmismatched-new-delete), although both use malloc and free
+namespace allocations {
+
+	std::atomic<size_t> count{ 0 };
+
+	[[gnu::noinline]] void* allocate(size_t size, size_t alignment) {
+		count.fetch_add(1, std::memory_order_relaxed);
+		if (size == 0)
+			size = 1;
+		void* ptr = alignment <= alignof(std::max_align_t) ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+		if (ptr)
+			return ptr;
+		throw std::bad_alloc{};
+	}
+
+	[[gnu::noinline]] void deallocate(void* ptr) noexcept {
+		std::free(ptr);
+	}
+
+}
+
+[[gnu::noinline]] void* operator new(size_t size) {
+	return allocations::allocate(size, alignof(std::max_align_t));
+}
+
+[[gnu::noinline]] void* operator new[](size_t size) {
+	return allocations::allocate(size, alignof(std::max_align_t));
+}
+
+[[gnu::noinline]] void* operator new(size_t size, std::align_val_t alignment) {
+	return allocations::allocate(size, static_cast<size_t>(alignment));
+}
+
+[[gnu::noinline]] void* operator new[](size_t size, std::align_val_t alignment) {
+	return allocations::allocate(size, static_cast<size_t>(alignment));
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, size_t) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::align_val_t) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, std::align_val_t) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+	allocations::deallocate(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+	allocations::deallocate(ptr);
+}
+
+// The byte-by-byte implementations the library used before the word-at-a-time engine, kept as a reference point
+namespace reference {
+
+	template<typename T>
+	size_t one_bit_count(const T& value) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+		size_t count{ 0 };
+
+		for (size_t i{ 0 }; i < sizeof(T); ++i) {
+			auto byte = static_cast<unsigned char>(ptr[i]);
+			while (byte) {
+				count += byte & 1;
+				byte >>= 1;
+			}
+		}
+
+		return count;
+	}
+
+	template<typename T>
+	size_t zero_bit_count(const T& value) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+		size_t count{ 0 };
+
+		for (size_t i{ 0 }; i < sizeof(T); ++i) {
+			auto byte = static_cast<unsigned char>(ptr[i]);
+			for (unsigned char j{ 0 }; j < IMD::BITS_PER_BYTE; ++j)
+				if ((byte & (1 << j)) == 0)
+					++count;
+		}
+
+		return count;
+	}
+
+	// Gathers the bits of <value> selected by <mask> one bit at a time, the way a decoder does it with IMD::modify_bit
+	template<typename T, typename U>
+	void extract_bits(const T& value, const T& mask, U& result) {
+		auto value_ptr = reinterpret_cast<const std::byte*>(&value);
+		auto mask_ptr = reinterpret_cast<const std::byte*>(&mask);
+		result = U{};
+		size_t position{ 0 };
+
+		for (size_t i{ 0 }; i < sizeof(T) * IMD::BITS_PER_BYTE; ++i)
+			if ((static_cast<unsigned char>(mask_ptr[i / IMD::BITS_PER_BYTE]) >> (i % IMD::BITS_PER_BYTE)) & 1)
+				IMD::modify_bit(result, position++, ((static_cast<unsigned char>(value_ptr[i / IMD::BITS_PER_BYTE]) >> (i % IMD::BITS_PER_BYTE)) & 1) != 0);
+	}
+
+}
+
+// An object of exactly <N> bytes
+template<size_t N>
+struct record {
+	std::byte data[N];
+};
+
+// The size in bytes of the arrays the span overloads are measured on
+constexpr size_t BULK_SIZE{ 1 << 20 };
+
+// The size in bytes of the object the formatting functions are measured on in bulk
+constexpr size_t TEXT_OBJECT_SIZE{ 1 << 16 };
+
+// Large enough for any formatted object of the benchmark, including the separators
+char text[TEXT_OBJECT_SIZE * 9 + 64];
+
+// A stream buffer that accepts and drops everything, so the print functions are measured without the cost of a terminal
+class discard_buffer : public std::streambuf {
+protected:
+	int_type overflow(int_type ch) override {
+		return traits_type::not_eof(ch);
+	}
+
+	std::streamsize xsputn(const char*, std::streamsize count) override {
+		return count;
+	}
+};
+
+discard_buffer discarded;
+std::ostream discard_stream{ &discarded };
+
+// Keeps the compiler from optimizing away the computation of <value>
+template<typename T>
+void do_not_optimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Returns the current value of the time stamp counter, or 0 where there is none
+inline std::uint64_t cycles() {
+#ifdef IMD_X86_SIMD
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+// A function of the library together with the number of bytes one call processes; <run> makes the given number of calls
+struct bench_case {
+	std::string name;
+	size_t bytes;
+	std::function<void(size_t)> run;
+};
+
+struct bench_result {
+	std::string name;
+	size_t bytes;
+	double ns_per_op;
+	double bytes_per_cycle;
+	double allocations_per_op;
+};
+
+// Fills <size> bytes starting at <ptr> with random values
+void randomize(std::byte* ptr, size_t size, std::uint64_t seed) {
+	std::mt19937_64 generator{ seed };
+	for (size_t i{ 0 }; i < size; ++i)
+		ptr[i] = static_cast<std::byte>(generator());
+}
+
+// Adds a case that calls <operation> with each record of a pool of random <N>-byte records in turn and the record after it.
+// The pool is a power of two records and stays within the L1 cache for small records
+template<size_t N, typename F>
+void add(std::vector<bench_case>& cases, std::string name, F operation) {
+	constexpr size_t POOL_BYTES{ 1 << 14 };
+	auto pool = std::make_shared<std::vector<record<N>>>(std::max<size_t>(8, POOL_BYTES / N));
+	randomize(reinterpret_cast<std::byte*>(pool->data()), pool->size() * N, N);
+
+	cases.push_back({ std::move(name), N, [pool, operation](size_t iterations) {
+		auto& records = *pool;
+		size_t mask{ records.size() - 1 };
+		for (size_t i{ 0 }; i < iterations; ++i)
+			operation(records[i & mask], records[(i + 1) & mask]);
+	} });
+}
+
+// Adds a case that calls <operation> with spans over two arrays of BULK_SIZE bytes
+template<typename F>
+void add_bulk(std::vector<bench_case>& cases, std::string name, F operation) {
+	auto first = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t));
+	auto second = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t));
+	randomize(reinterpret_cast<std::byte*>(first->data()), BULK_SIZE, 1);
+	randomize(reinterpret_cast<std::byte*>(second->data()), BULK_SIZE, 2);
+
+	cases.push_back({ std::move(name), BULK_SIZE, [first, second, operation](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			operation(std::span{ *first }, std::span{ *second });
+	} });
+}
+
+// Adds a case that calls <predicate> with a span over an array of BULK_SIZE bytes all equal to <pattern>.
+// The predicates stop at the first byte that decides them, so they are measured on ranges they have to read to the end
+template<typename F>
+void add_bulk_predicate(std::vector<bench_case>& cases, std::string name, std::uint64_t pattern, F predicate) {
+	auto values = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t), pattern);
+
+	cases.push_back({ std::move(name), BULK_SIZE, [values, predicate](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			do_not_optimize(predicate(std::span{ *values }));
+	} });
+}
+
+// The fields of an <N>-byte record for the field-wise byte swap: its two halves, or the whole record if it has one byte
+template<size_t N>
+const std::vector<IMD::field>& record_fields() {
+	static const std::vector<IMD::field> fields = N > 1 ? std::vector<IMD::field>{ { 0, N / 2 }, { N / 2, N - N / 2 } } : std::vector<IMD::field>{ { 0, N } };
+	return fields;
+}
+
+// The formatting and printing functions over random <N>-byte records
+template<size_t N>
+void add_format_cases(std::vector<bench_case>& cases, IMD::file_descriptor null_device) {
+	using T = record<N>;
+	char* const end = text + sizeof(text);
+
+	add<N>(cases, "format_hex_bytes", [end](const T& value, const T&) { do_not_optimize(IMD::format_hex_bytes(text, end, value)); });
+	add<N>(cases, "format_dec_bytes", [end](const T& value, const T&) { do_not_optimize(IMD::format_dec_bytes(text, end, value)); });
+	add<N>(cases, "format_oct_bytes", [end](const T& value, const T&) { do_not_optimize(IMD::format_oct_bytes(text, end, value)); });
+	add<N>(cases, "format_bin_bytes", [end](const T& value, const T&) { do_not_optimize(IMD::format_bin_bytes(text, end, value)); });
+	add<N>(cases, "format_bits", [end](const T& value, const T&) { do_not_optimize(IMD::format_bits(text, end, value)); });
+	add<N>(cases, "format_bits(no separator)", [end](const T& value, const T&) { do_not_optimize(IMD::format_bits(text, end, value, "")); });
+
+	add<N>(cases, "print_hex_bytes(ostream)", [](const T& value, const T&) { IMD::print_hex_bytes(discard_stream, value); });
+	add<N>(cases, "print_dec_bytes(ostream)", [](const T& value, const T&) { IMD::print_dec_bytes(discard_stream, value); });
+	add<N>(cases, "print_oct_bytes(ostream)", [](const T& value, const T&) { IMD::print_oct_bytes(discard_stream, value); });
+	add<N>(cases, "print_bin_bytes(ostream)", [](const T& value, const T&) { IMD::print_bin_bytes(discard_stream, value); });
+	add<N>(cases, "print_bits(ostream)", [](const T& value, const T&) { IMD::print_bits(discard_stream, value); });
+	add<N>(cases, "println_hex_bytes(ostream)", [](const T& value, const T&) { IMD::println_hex_bytes(discard_stream, value); });
+	add<N>(cases, "println_dec_bytes(ostream)", [](const T& value, const T&) { IMD::println_dec_bytes(discard_stream, value); });
+	add<N>(cases, "println_oct_bytes(ostream)", [](const T& value, const T&) { IMD::println_oct_bytes(discard_stream, value); });
+	add<N>(cases, "println_bin_bytes(ostream)", [](const T& value, const T&) { IMD::println_bin_bytes(discard_stream, value); });
+	add<N>(cases, "println_bits(ostream)", [](const T& value, const T&) { IMD::println_bits(discard_stream, value); });
+	if (null_device.fd >= 0) {
+		add<N>(cases, "print_hex_bytes(fd)", [null_device](const T& value, const T&) { IMD::print_hex_bytes(null_device, value); });
+		add<N>(cases, "print_bits(fd)", [null_device](const T& value, const T&) { IMD::print_bits(null_device, value); });
+		add<N>(cases, "println_bits(fd)", [null_device](const T& value, const T&) { IMD::println_bits(null_device, value); });
+	}
+
+	add<N>(cases, "bits_to_chars", [end](const T& value, const T&) { do_not_optimize(IMD::bits_to_chars(text, end, value)); });
+	add<N>(cases, "bytes_to_string", [](const T& value, const T&) { do_not_optimize(IMD::bytes_to_string(value)); });
+	add<N>(cases, "bits_to_string", [](const T& value, const T&) { do_not_optimize(IMD::bits_to_string(value)); });
+	add<N>(cases, "bytes_to_container", [](const T& value, const T&) { do_not_optimize(IMD::bytes_to_container(value)); });
+	add<N>(cases, "bits_to_container", [](const T& value, const T&) { do_not_optimize(IMD::bits_to_container(value)); });
+	add<N>(cases, "bytes_to_container<uint8_t>", [](const T& value, const T&) { do_not_optimize(IMD::bytes_to_container<T, std::vector<std::uint8_t>>(value)); });
+	add<N>(cases, "bits_to_container<uint8_t>", [](const T& value, const T&) { do_not_optimize(IMD::bits_to_container<T, std::vector<std::uint8_t>>(value)); });
+	add<N>(cases, "bytes_to_container(span)", [](const T& value, const T&) {
+		static std::array<std::uint8_t, N> out;
+		do_not_optimize(IMD::bytes_to_container(value, std::span{ out }));
+	});
+	add<N>(cases, "bits_to_container(span)", [](const T& value, const T&) {
+		static std::array<std::uint8_t, N * IMD::BITS_PER_BYTE> out;
+		do_not_optimize(IMD::bits_to_container(value, std::span{ out }));
+	});
+	add<N>(cases, "bytes_to_container(span<bool>)", [](const T& value, const T&) {
+		static std::array<bool, N> out;
+		do_not_optimize(IMD::bytes_to_container(value, std::span{ out }));
+	});
+	add<N>(cases, "bits_to_container(span<bool>)", [](const T& value, const T&) {
+		static std::array<bool, N * IMD::BITS_PER_BYTE> out;
+		do_not_optimize(IMD::bits_to_container(value, std::span{ out }));
+	});
+}
+
+// Every other single object function over random <N>-byte records
+template<size_t N>
+void add_object_cases(std::vector<bench_case>& cases) {
+	using T = record<N>;
+
+	add<N>(cases, "reference::one_bit_count", [](const T& value, const T&) { do_not_optimize(reference::one_bit_count(value)); });
+	add<N>(cases, "reference::zero_bit_count", [](const T& value, const T&) { do_not_optimize(reference::zero_bit_count(value)); });
+
+	add<N>(cases, "restore_value", [](const T& value, const T&) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+		do_not_optimize(IMD::restore_value<T>(ptr, ptr + N));
+	});
+	add<N>(cases, "modify_byte", [](T& value, const T&) { IMD::modify_byte(value, N / 2, std::byte{ 0x5A }); });
+	add<N>(cases, "modify_bit", [](T& value, const T&) { IMD::modify_bit(value, N * IMD::BITS_PER_BYTE / 2, true); });
+	add<N>(cases, "reference::fill_bits", [](T& value, const T&) {
+		for (size_t i{ 1 }; i < N * IMD::BITS_PER_BYTE - 1; ++i)
+			IMD::modify_bit(value, i, true);
+	});
+	add<N>(cases, "fill_bits", [](T& value, const T&) { IMD::fill_bits(value, 1, N * IMD::BITS_PER_BYTE - 1, true); });
+	add<N>(cases, "get_bits", [](const T& value, const T&) { do_not_optimize(IMD::get_bits(value, N * IMD::BITS_PER_BYTE / 3, std::min<size_t>(N * IMD::BITS_PER_BYTE / 2, 64))); });
+	add<N>(cases, "set_bits", [](T& value, const T&) { IMD::set_bits(value, N * IMD::BITS_PER_BYTE / 3, std::min<size_t>(N * IMD::BITS_PER_BYTE / 2, 64), 0x5A5A); });
+	add<N>(cases, "one_bit_count(range)", [](const T& value, const T&) { do_not_optimize(IMD::one_bit_count(value, 1, N * IMD::BITS_PER_BYTE - 1)); });
+	add<N>(cases, "all_bits_zero(range)", [](const T& value, const T&) { do_not_optimize(IMD::all_bits_zero(value, 1, N * IMD::BITS_PER_BYTE - 1)); });
+	add<N>(cases, "compare_bytes", [](const T& first, const T& second) { do_not_optimize(IMD::compare_bytes(first, second)); });
+	add<N>(cases, "swap_bytes", [](T& first, T& second) { IMD::swap_bytes(first, second); });
+
+	add<N>(cases, "invert_bits", [](T& value, const T&) { IMD::invert_bits(value); });
+	add<N>(cases, "and_bits", [](T& destination, const T& source) { IMD::and_bits(destination, source); });
+	add<N>(cases, "or_bits", [](T& destination, const T& source) { IMD::or_bits(destination, source); });
+	add<N>(cases, "xor_bits", [](T& destination, const T& source) { IMD::xor_bits(destination, source); });
+	add<N>(cases, "andnot_bits", [](T& destination, const T& source) { IMD::andnot_bits(destination, source); });
+	add<N>(cases, "and_bit_count", [](const T& first, const T& second) { do_not_optimize(IMD::and_bit_count(first, second)); });
+	add<N>(cases, "or_bit_count", [](const T& first, const T& second) { do_not_optimize(IMD::or_bit_count(first, second)); });
+	add<N>(cases, "xor_bit_count", [](const T& first, const T& second) { do_not_optimize(IMD::xor_bit_count(first, second)); });
+	add<N>(cases, "andnot_bit_count", [](const T& first, const T& second) { do_not_optimize(IMD::andnot_bit_count(first, second)); });
+
+	add<N>(cases, "one_bit_count", [](const T& value, const T&) { do_not_optimize(IMD::one_bit_count(value)); });
+	add<N>(cases, "zero_bit_count", [](const T& value, const T&) { do_not_optimize(IMD::zero_bit_count(value)); });
+	add<N>(cases, "is_power_of_two", [](const T& value, const T&) { do_not_optimize(IMD::is_power_of_two(value)); });
+	add<N>(cases, "all_bits_one", [](const T& value, const T&) { do_not_optimize(IMD::all_bits_one(value)); });
+	add<N>(cases, "all_bits_zero", [](const T& value, const T&) { do_not_optimize(IMD::all_bits_zero(value)); });
+	add<N>(cases, "any_bits_one", [](const T& value, const T&) { do_not_optimize(IMD::any_bits_one(value)); });
+	add<N>(cases, "any_bits_zero", [](const T& value, const T&) { do_not_optimize(IMD::any_bits_zero(value)); });
+
+	add<N>(cases, "find_first_set", [](const T& value, const T&) { do_not_optimize(IMD::find_first_set(value)); });
+	add<N>(cases, "find_last_set", [](const T& value, const T&) { do_not_optimize(IMD::find_last_set(value)); });
+	add<N>(cases, "find_next_set", [](const T& value, const T&) { do_not_optimize(IMD::find_next_set(value, N * IMD::BITS_PER_BYTE / 2)); });
+	add<N>(cases, "find_first_zero", [](const T& value, const T&) { do_not_optimize(IMD::find_first_zero(value)); });
+	add<N>(cases, "find_last_zero", [](const T& value, const T&) { do_not_optimize(IMD::find_last_zero(value)); });
+	add<N>(cases, "find_next_zero", [](const T& value, const T&) { do_not_optimize(IMD::find_next_zero(value, N * IMD::BITS_PER_BYTE / 2)); });
+	add<N>(cases, "for_each_set_bit", [](const T& value, const T&) {
+		size_t sum{ 0 };
+		IMD::for_each_set_bit(value, [&sum](size_t index) { sum += index; });
+		do_not_optimize(sum);
+	});
+	add<N>(cases, "decode_set_bits", [](const T& value, const T&) {
+		static std::uint32_t indices[N * IMD::BITS_PER_BYTE];
+		do_not_optimize(IMD::decode_set_bits(value, indices));
+	});
+	add<N>(cases, "reference::extract_bits", [](const T& value, const T& mask) {
+		static T result;
+		reference::extract_bits(value, mask, result);
+		do_not_optimize(result);
+	});
+	add<N>(cases, "extract_bits", [](const T& value, const T& mask) {
+		static T result;
+		do_not_optimize(IMD::extract_bits(value, mask, result));
+	});
+	add<N>(cases, "deposit_bits", [](const T& source, const T& mask) {
+		static T destination;
+		do_not_optimize(IMD::deposit_bits(source, mask, destination));
+	});
+	add<N>(cases, "countr_zero", [](const T& value, const T&) { do_not_optimize(IMD::countr_zero(value)); });
+	add<N>(cases, "countl_zero", [](const T& value, const T&) { do_not_optimize(IMD::countl_zero(value)); });
+	add<N>(cases, "countr_one", [](const T& value, const T&) { do_not_optimize(IMD::countr_one(value)); });
+	add<N>(cases, "countl_one", [](const T& value, const T&) { do_not_optimize(IMD::countl_one(value)); });
+
+	add<N>(cases, "byte_swap", [](T& value, const T&) { IMD::byte_swap(value); });
+	add<N>(cases, "byte_swap_fields", [](T& value, const T&) { IMD::byte_swap_fields(value, record_fields<N>()); });
+	add<N>(cases, "to_big_endian", [](T& value, const T&) { value = IMD::to_big_endian(value); });
+	add<N>(cases, "to_little_endian", [](T& value, const T&) { value = IMD::to_little_endian(value); });
+	add<N>(cases, "from_big_endian", [](T& value, const T&) { value = IMD::from_big_endian(value); });
+	add<N>(cases, "from_little_endian", [](T& value, const T&) { value = IMD::from_little_endian(value); });
+
+	add<N>(cases, "shift_left_bits", [](T& value, const T&) { IMD::shift_left_bits(value, 3); });
+	add<N>(cases, "shift_right_bits", [](T& value, const T&) { IMD::shift_right_bits(value, 3); });
+	add<N>(cases, "shift_left_bits(copy)", [](const T& source, T& destination) { IMD::shift_left_bits(source, destination, 3); });
+	add<N>(cases, "shift_right_bits(copy)", [](const T& source, T& destination) { IMD::shift_right_bits(source, destination, 3); });
+	add<N>(cases, "rotate_left_bits", [](T& value, const T&) { IMD::rotate_left_bits(value, 3); });
+	add<N>(cases, "rotate_right_bits", [](T& value, const T&) { IMD::rotate_right_bits(value, 3); });
+	add<N>(cases, "rotate_left_bits(copy)", [](const T& source, T& destination) { IMD::rotate_left_bits(source, destination, 3); });
+	add<N>(cases, "rotate_right_bits(copy)", [](const T& source, T& destination) { IMD::rotate_right_bits(source, destination, 3); });
+}
+
+// The span overloads over arrays of BULK_SIZE bytes
+void add_bulk_cases(std::vector<bench_case>& cases) {
+	using span = std::span<std::uint64_t>;
+	static const std::vector<IMD::field> fields{ { 0, 4 }, { 4, 2 }, { 6, 2 } };
+
+	add_bulk(cases, "modify_byte(span)", [](span values, span) { IMD::modify_byte(values, BULK_SIZE / 2, std::byte{ 0x5A }); });
+	add_bulk(cases, "modify_bit(span)", [](span values, span) { IMD::modify_bit(values, BULK_SIZE * IMD::BITS_PER_BYTE / 2, true); });
+	add_bulk(cases, "fill_bits(span)", [](span values, span) { IMD::fill_bits(values, 3, BULK_SIZE * IMD::BITS_PER_BYTE - 3, true); });
+	add_bulk(cases, "one_bit_count(span, range)", [](span values, span) { do_not_optimize(IMD::one_bit_count(values, 3, BULK_SIZE * IMD::BITS_PER_BYTE - 3)); });
+	add_bulk_predicate(cases, "all_bits_zero(span, range)", 0, [](span values) { return IMD::all_bits_zero(values, 3, BULK_SIZE * IMD::BITS_PER_BYTE - 3); });
+	add_bulk(cases, "compare_bytes(span)", [](span first, span) { do_not_optimize(IMD::compare_bytes(first, first)); });
+	add_bulk(cases, "swap_bytes(span)", [](span first, span second) { IMD::swap_bytes(first, second); });
+
+	add_bulk(cases, "invert_bits(span)", [](span values, span) { IMD::invert_bits(values); });
+	add_bulk(cases, "and_bits(span)", [](span destination, span source) { IMD::and_bits(destination, source); });
+	add_bulk(cases, "or_bits(span)", [](span destination, span source) { IMD::or_bits(destination, source); });
+	add_bulk(cases, "xor_bits(span)", [](span destination, span source) { IMD::xor_bits(destination, source); });
+	add_bulk(cases, "andnot_bits(span)", [](span destination, span source) { IMD::andnot_bits(destination, source); });
+	add_bulk(cases, "xor_bits(span, result)", [](span first, span second) { IMD::xor_bits(first, second, first); });
+	add_bulk(cases, "and_bit_count(span)", [](span first, span second) { do_not_optimize(IMD::and_bit_count(first, second)); });
+	add_bulk(cases, "or_bit_count(span)", [](span first, span second) { do_not_optimize(IMD::or_bit_count(first, second)); });
+	add_bulk(cases, "xor_bit_count(span)", [](span first, span second) { do_not_optimize(IMD::xor_bit_count(first, second)); });
+	add_bulk(cases, "andnot_bit_count(span)", [](span first, span second) { do_not_optimize(IMD::andnot_bit_count(first, second)); });
+
+	add_bulk(cases, "one_bit_count(span)", [](span values, span) { do_not_optimize(IMD::one_bit_count(values)); });
+	add_bulk(cases, "zero_bit_count(span)", [](span values, span) { do_not_optimize(IMD::zero_bit_count(values)); });
+	add_bulk(cases, "is_power_of_two(span)", [](span values, span) { do_not_optimize(IMD::is_power_of_two(values)); });
+	add_bulk_predicate(cases, "all_bits_one(span)", ~std::uint64_t{ 0 }, [](span values) { return IMD::all_bits_one(values); });
+	add_bulk_predicate(cases, "all_bits_zero(span)", 0, [](span values) { return IMD::all_bits_zero(values); });
+	add_bulk_predicate(cases, "any_bits_one(span)", 0, [](span values) { return IMD::any_bits_one(values); });
+	add_bulk_predicate(cases, "any_bits_zero(span)", ~std::uint64_t{ 0 }, [](span values) { return IMD::any_bits_zero(values); });
+
+	// The searches likewise only scan the whole range when what they look for is not there, or only at the far end
+	add_bulk_predicate(cases, "find_first_set(span)", 0, [](span values) { return IMD::find_first_set(values); });
+	add_bulk_predicate(cases, "find_last_set(span)", 0, [](span values) { return IMD::find_last_set(values); });
+	add_bulk_predicate(cases, "find_next_zero(span)", ~std::uint64_t{ 0 }, [](span values) { return IMD::find_next_zero(values, 1); });
+	add_bulk_predicate(cases, "countl_zero(span)", 0, [](span values) { return IMD::countl_zero(values); });
+
+	add_bulk(cases, "extract_bits(span)", [](span values, span mask) { do_not_optimize(IMD::extract_bits(values, mask, values)); });
+	add_bulk(cases, "deposit_bits(span)", [](span source, span mask) {
+		static std::vector<std::uint64_t> destination(BULK_SIZE / sizeof(std::uint64_t));
+		do_not_optimize(IMD::deposit_bits(source, mask, std::span{ destination }));
+	});
+
+	add_bulk(cases, "byte_swap(span)", [](span values, span) { IMD::byte_swap(values); });
+	add_bulk(cases, "byte_swap_fields(span)", [](span values, span) { IMD::byte_swap_fields(values, fields); });
+	add_bulk(cases, "to_big_endian(span)", [](span values, span) { IMD::to_big_endian(values); });
+	add_bulk(cases, "to_little_endian(span)", [](span values, span) { IMD::to_little_endian(values); });
+	add_bulk(cases, "from_big_endian(span)", [](span values, span) { IMD::from_big_endian(values); });
+	add_bulk(cases, "from_little_endian(span)", [](span values, span) { IMD::from_little_endian(values); });
+	add_bulk(cases, "to_big_endian(span, fields)", [](span values, span) { IMD::to_big_endian(values, fields); });
+
+	add_bulk(cases, "shift_left_bits(span)", [](span values, span) { IMD::shift_left_bits(values, 3); });
+	add_bulk(cases, "shift_right_bits(span)", [](span values, span) { IMD::shift_right_bits(values, 3); });
+	add_bulk(cases, "shift_left_bits(span, copy)", [](span source, span destination) { IMD::shift_left_bits(source, destination, 3); });
+	add_bulk(cases, "shift_right_bits(span, copy)", [](span source, span destination) { IMD::shift_right_bits(source, destination, 3); });
+	add_bulk(cases, "rotate_left_bits(span)", [](span values, span) { IMD::rotate_left_bits(values, 3); });
+	add_bulk(cases, "rotate_right_bits(span)", [](span values, span) { IMD::rotate_right_bits(values, 3); });
+}
+
+// The bit_vector operations over two vectors of BULK_SIZE bytes, and its single bit access over the first one
+void add_bit_vector_cases(std::vector<bench_case>& cases) {
+	auto first = std::make_shared<IMD::bit_vector>(BULK_SIZE * IMD::BITS_PER_BYTE);
+	auto second = std::make_shared<IMD::bit_vector>(BULK_SIZE * IMD::BITS_PER_BYTE);
+	randomize(reinterpret_cast<std::byte*>(first->words().data()), BULK_SIZE, 1);
+	randomize(reinterpret_cast<std::byte*>(second->words().data()), BULK_SIZE, 2);
+
+	auto add_vector = [&cases, first, second](std::string name, size_t bytes, auto operation) {
+		cases.push_back({ std::move(name), bytes, [first, second, operation](size_t iterations) {
+			for (size_t i{ 0 }; i < iterations; ++i)
+				operation(*first, *second, i);
+		} });
+	};
+	using vector = IMD::bit_vector;
+	constexpr size_t BITS{ BULK_SIZE * IMD::BITS_PER_BYTE };
+
+	add_vector("bit_vector::test", 1, [](vector& v, vector&, size_t i) { do_not_optimize(v.test(i * 7919 % BITS)); });
+	add_vector("bit_vector::flip", 1, [](vector& v, vector&, size_t i) { v.flip(i * 7919 % BITS); });
+	add_vector("bit_vector::count", BULK_SIZE, [](vector& v, vector&, size_t) { do_not_optimize(v.count()); });
+	add_vector("bit_vector::none", BULK_SIZE, [](vector&, vector&, size_t) {
+		static const vector zeros(BITS);
+		do_not_optimize(zeros.none());
+	});
+	add_vector("bit_vector::operator&=", BULK_SIZE, [](vector& v, vector& other, size_t) { v &= other; });
+	add_vector("bit_vector::operator^=", BULK_SIZE, [](vector& v, vector& other, size_t) { v ^= other; });
+	add_vector("bit_vector::flip()", BULK_SIZE, [](vector& v, vector&, size_t) { v.flip(); });
+	add_vector("bit_vector::operator<<=", BULK_SIZE, [](vector& v, vector&, size_t) { v <<= 3; });
+	add_vector("bit_vector::operator>>=", BULK_SIZE, [](vector& v, vector&, size_t) { v >>= 3; });
+	add_vector("bit_vector::from_value", 4096, [](vector&, vector&, size_t) {
+		static const record<4096> value{};
+		do_not_optimize(IMD::bit_vector::from_value(value));
+	});
+}
+
+// Decoding and iterating the bits set to 1 of BULK_SIZE bytes in which about <percent> percent of the bits are set
+void add_decode_cases(std::vector<bench_case>& cases, unsigned percent) {
+	auto bits = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t));
+	std::mt19937_64 generator{ percent };
+	for (size_t i{ 0 }; i < BULK_SIZE * IMD::BITS_PER_BYTE; ++i)
+		if (generator() % 100 < percent)
+			(*bits)[i / 64] |= std::uint64_t{ 1 } << (i % 64);
+	auto indices = std::make_shared<std::vector<std::uint32_t>>(IMD::one_bit_count(std::span{ *bits }));
+	auto suffix = "(span, " + std::to_string(percent) + "%)";
+
+	cases.push_back({ "decode_set_bits" + suffix, BULK_SIZE, [bits, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			do_not_optimize(IMD::decode_set_bits(std::span{ *bits }, indices->data()));
+	} });
+	cases.push_back({ "for_each_set_bit" + suffix, BULK_SIZE, [bits](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i) {
+			size_t sum{ 0 };
+			IMD::for_each_set_bit(std::span{ *bits }, [&sum](size_t index) { sum += index; });
+			do_not_optimize(sum);
+		}
+	} });
+}
+
+// Applying a patch of 64Ki edits to an array of BULK_SIZE bytes, one modify_byte/modify_bit call per edit or as a batch.
+// The patch is sorted by index and either scattered over the whole array or <dense> (consecutive bits and bytes)
+void add_patch_cases(std::vector<bench_case>& cases, bool dense) {
+	constexpr size_t EDITS{ 1 << 16 };
+	auto values = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t));
+	auto byte_edits = std::make_shared<std::vector<IMD::byte_edit>>(EDITS);
+	auto bit_edits = std::make_shared<std::vector<IMD::bit_edit>>(EDITS);
+	std::mt19937_64 generator{ 4 };
+	for (size_t i{ 0 }; i < EDITS; ++i) {
+		(*byte_edits)[i] = { dense ? i : generator() % BULK_SIZE, static_cast<std::byte>(generator()) };
+		(*bit_edits)[i] = { dense ? i : generator() % (BULK_SIZE * IMD::BITS_PER_BYTE), (generator() & 1) != 0 };
+	}
+	std::sort(byte_edits->begin(), byte_edits->end(), [](const auto& first, const auto& second) { return first.index < second.index; });
+	std::sort(bit_edits->begin(), bit_edits->end(), [](const auto& first, const auto& second) { return first.index < second.index; });
+	std::string suffix{ dense ? "(span, dense)" : "(span, scattered)" };
+
+	cases.push_back({ "modify_byte loop" + suffix, EDITS, [values, byte_edits](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (const auto& edit : *byte_edits)
+				IMD::modify_byte(std::span{ *values }, edit.index, edit.value);
+	} });
+	cases.push_back({ "modify_bytes" + suffix, EDITS, [values, byte_edits](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			IMD::modify_bytes(std::span{ *values }, *byte_edits);
+	} });
+	cases.push_back({ "modify_bit loop" + suffix, EDITS, [values, bit_edits](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (const auto& edit : *bit_edits)
+				IMD::modify_bit(std::span{ *values }, edit.index, edit.value);
+	} });
+	cases.push_back({ "modify_bits" + suffix, EDITS, [values, bit_edits](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			IMD::modify_bits(std::span{ *values }, *bit_edits);
+	} });
+}
+
+// The hot loop of a decoder: 4Ki edits and reads at random indices of a 64-byte record, through the checked, unchecked and try_
+// variants of modify_byte, modify_bit and restore_value
+void add_check_cases(std::vector<bench_case>& cases) {
+	constexpr size_t EDITS{ 1 << 12 };
+	using T = record<64>;
+	auto value = std::make_shared<T>();
+	auto indices = std::make_shared<std::vector<size_t>>(EDITS);
+	std::mt19937_64 generator{ 5 };
+	for (auto& index : *indices)
+		index = generator() % sizeof(T);
+	auto bytes = std::make_shared<std::vector<std::byte>>(EDITS + sizeof(std::uint64_t));
+
+	cases.push_back({ "modify_byte loop(checked)", EDITS, [value, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t index : *indices)
+				IMD::modify_byte(*value, index, std::byte{ 0x5A });
+		do_not_optimize(*value);
+	} });
+	cases.push_back({ "modify_byte_unchecked loop", EDITS, [value, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t index : *indices)
+				IMD::modify_byte_unchecked(*value, index, std::byte{ 0x5A });
+		do_not_optimize(*value);
+	} });
+	cases.push_back({ "try_modify_byte loop", EDITS, [value, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t index : *indices)
+				do_not_optimize(IMD::try_modify_byte(*value, index, std::byte{ 0x5A }));
+		do_not_optimize(*value);
+	} });
+	cases.push_back({ "modify_bit loop(checked)", EDITS, [value, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t index : *indices)
+				IMD::modify_bit(*value, index * IMD::BITS_PER_BYTE + index % 8, (index & 1) != 0);
+		do_not_optimize(*value);
+	} });
+	cases.push_back({ "modify_bit_unchecked loop", EDITS, [value, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t index : *indices)
+				IMD::modify_bit_unchecked(*value, index * IMD::BITS_PER_BYTE + index % 8, (index & 1) != 0);
+		do_not_optimize(*value);
+	} });
+	cases.push_back({ "try_modify_bit loop", EDITS, [value, indices](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t index : *indices)
+				do_not_optimize(IMD::try_modify_bit(*value, index * IMD::BITS_PER_BYTE + index % 8, (index & 1) != 0));
+		do_not_optimize(*value);
+	} });
+	cases.push_back({ "restore_value loop(checked)", EDITS, [bytes](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t offset{ 0 }; offset < EDITS; ++offset)
+				do_not_optimize(IMD::restore_value<std::uint64_t>(bytes->data() + offset, bytes->data() + bytes->size()));
+	} });
+	cases.push_back({ "restore_value_unchecked loop", EDITS, [bytes](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t offset{ 0 }; offset < EDITS; ++offset)
+				do_not_optimize(IMD::restore_value_unchecked<std::uint64_t>(bytes->data() + offset, bytes->data() + bytes->size()));
+	} });
+	cases.push_back({ "try_restore_value loop", EDITS, [bytes](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			for (size_t offset{ 0 }; offset < EDITS; ++offset) {
+				std::uint64_t value{};
+				do_not_optimize(IMD::try_restore_value(bytes->data() + offset, bytes->data() + bytes->size(), value));
+				do_not_optimize(value);
+			}
+	} });
+}
+
+// Decoding BULK_SIZE bytes of 8-byte records one restore_value call at a time, in bulk with restore_values, and with a
+// record_reader in the host and in the opposite byte order
+void add_record_cases(std::vector<bench_case>& cases) {
+	using word = std::uint64_t;
+	constexpr std::endian OPPOSITE{ std::endian::native == std::endian::little ? std::endian::big : std::endian::little };
+	auto bytes = std::make_shared<std::vector<std::byte>>(BULK_SIZE);
+	auto values = std::make_shared<std::vector<word>>(BULK_SIZE / sizeof(word));
+	randomize(bytes->data(), BULK_SIZE, 6);
+
+	cases.push_back({ "restore_value loop(span)", BULK_SIZE, [bytes](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i) {
+			word sum{ 0 };
+			for (size_t offset{ 0 }; offset < BULK_SIZE; offset += sizeof(word))
+				sum += IMD::restore_value<word>(bytes->data() + offset, bytes->data() + BULK_SIZE);
+			do_not_optimize(sum);
+		}
+	} });
+	cases.push_back({ "restore_values(span)", BULK_SIZE, [bytes, values](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i) {
+			IMD::restore_values(std::span<const std::byte>{ *bytes }, std::span{ *values });
+			do_not_optimize(values->data());
+		}
+	} });
+	cases.push_back({ "record_reader(span)", BULK_SIZE, [bytes](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i) {
+			word sum{ 0 };
+			for (word value : IMD::record_reader<word>{ *bytes })
+				sum += value;
+			do_not_optimize(sum);
+		}
+	} });
+	cases.push_back({ "record_reader<opposite>(span)", BULK_SIZE, [bytes](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i) {
+			word sum{ 0 };
+			for (word value : IMD::record_reader<word, OPPOSITE>{ *bytes })
+				sum += value;
+			do_not_optimize(sum);
+		}
+	} });
+}
+
+#if __has_include(<sys/mman.h>)
+// The span overloads over a file of BULK_SIZE random bytes mapped with IMD::mapped_bytes, which is left in the temporary
+// directory and stays in the page cache, so this measures the operations on the mapping rather than the disk
+void add_mapped_cases(std::vector<bench_case>& cases) {
+	auto path = (std::filesystem::temp_directory_path() / "imd_benchmark_mapped.bin").string();
+	{
+		std::vector<std::byte> bytes(BULK_SIZE);
+		randomize(bytes.data(), BULK_SIZE, 7);
+		std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+		out.write(reinterpret_cast<const char*>(bytes.data()), BULK_SIZE);
+	}
+	auto mapping = std::make_shared<IMD::mapped_bytes>(path, IMD::mapped_bytes::access::read_write);
+
+	auto add_mapped = [&cases, mapping](std::string name, auto operation) {
+		cases.push_back({ std::move(name), BULK_SIZE, [mapping, operation](size_t iterations) {
+			for (size_t i{ 0 }; i < iterations; ++i)
+				operation(mapping->as_writable_span<std::uint64_t>());
+		} });
+	};
+	add_mapped("one_bit_count(mapped)", [](auto values) { do_not_optimize(IMD::one_bit_count(values)); });
+	add_mapped("invert_bits(mapped)", [](auto values) { IMD::invert_bits(values); });
+	add_mapped("shift_left_bits(mapped)", [](auto values) { IMD::shift_left_bits(values, 3); });
+	add_mapped("byte_swap(mapped)", [](auto values) { IMD::byte_swap(values); });
+}
+#endif
+
+// The parallel overloads over an array of 64 MiB, which does not fit in the caches, on 1, 2, 4, ... threads up to all the
+// hardware threads, to show how they scale
+void add_parallel_cases(std::vector<bench_case>& cases) {
+	constexpr size_t SIZE{ 1 << 26 };
+	auto values = std::make_shared<std::vector<std::uint64_t>>(SIZE / sizeof(std::uint64_t));
+	auto zeros = std::make_shared<std::vector<std::uint64_t>>(SIZE / sizeof(std::uint64_t));
+	randomize(reinterpret_cast<std::byte*>(values->data()), SIZE, 8);
+
+	size_t hardware{ std::max(1u, std::thread::hardware_concurrency()) };
+	for (size_t threads{ 1 }; threads <= hardware; threads = threads < hardware && threads * 2 > hardware ? hardware : threads * 2) {
+		IMD::parallel_policy policy{ threads };
+		std::string suffix{ "(par, " + std::to_string(threads) + (threads == 1 ? " thread)" : " threads)") };
+
+		cases.push_back({ "one_bit_count" + suffix, SIZE, [values, policy](size_t iterations) {
+			for (size_t i{ 0 }; i < iterations; ++i)
+				do_not_optimize(IMD::one_bit_count(policy, std::span{ *values }));
+		} });
+		cases.push_back({ "all_bits_zero" + suffix, SIZE, [zeros, policy](size_t iterations) {
+			for (size_t i{ 0 }; i < iterations; ++i)
+				do_not_optimize(IMD::all_bits_zero(policy, std::span{ *zeros }));
+		} });
+		cases.push_back({ "invert_bits" + suffix, SIZE, [values, policy](size_t iterations) {
+			for (size_t i{ 0 }; i < iterations; ++i)
+				IMD::invert_bits(policy, std::span{ *values });
+		} });
+		if (threads == hardware)
+			break;
+	}
+}
+
+// Unpacking the bits of BULK_SIZE random bytes into one byte per bit and packing them back, against bits_to_container into a
+// std::vector<bool>, the way it was done before
+void add_unpack_cases(std::vector<bench_case>& cases) {
+	auto packed = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t));
+	auto unpacked = std::make_shared<std::vector<std::uint8_t>>(BULK_SIZE * IMD::BITS_PER_BYTE);
+	randomize(reinterpret_cast<std::byte*>(packed->data()), BULK_SIZE, 9);
+
+	cases.push_back({ "unpack_bits(span)", BULK_SIZE, [packed, unpacked](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			IMD::unpack_bits(std::span{ *packed }, std::span{ *unpacked });
+		do_not_optimize(unpacked->data());
+	} });
+	cases.push_back({ "pack_bits(span)", BULK_SIZE, [packed, unpacked](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			IMD::pack_bits(std::span{ *unpacked }, std::span{ *packed });
+		do_not_optimize(packed->data());
+	} });
+	cases.push_back({ "reference::bits_to_container(span)", BULK_SIZE, [packed](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i) {
+			std::vector<bool> bits;
+			for (std::uint64_t word : *packed)
+				for (unsigned bit{ 0 }; bit < 64; ++bit)
+					bits.push_back((word >> bit) & 1);
+			do_not_optimize(bits.size());
+		}
+	} });
+}
+
+// Dumping BULK_SIZE random bytes and BULK_SIZE zero bytes, which are squeezed into a single "*" line, to /dev/null
+void add_hexdump_cases(std::vector<bench_case>& cases, IMD::file_descriptor null_device) {
+	if (null_device.fd < 0)
+		return;
+
+	auto random = std::make_shared<std::vector<std::byte>>(BULK_SIZE);
+	auto zeros = std::make_shared<std::vector<std::byte>>(BULK_SIZE);
+	randomize(random->data(), BULK_SIZE, 10);
+
+	cases.push_back({ "hexdump(fd, span)", BULK_SIZE, [random, null_device](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			IMD::hexdump(null_device, std::span{ *random });
+	} });
+	cases.push_back({ "hexdump(fd, span, zeros)", BULK_SIZE, [zeros, null_device](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			IMD::hexdump(null_device, std::span{ *zeros });
+	} });
+}
+
+// Building a rank_select index over BULK_SIZE random bytes, and random rank and select queries on it
+void add_rank_select_cases(std::vector<bench_case>& cases) {
+	auto bits = std::make_shared<std::vector<std::uint64_t>>(BULK_SIZE / sizeof(std::uint64_t));
+	randomize(reinterpret_cast<std::byte*>(bits->data()), BULK_SIZE, 1);
+	auto index = std::make_shared<IMD::rank_select>(std::span{ *bits });
+
+	cases.push_back({ "rank_select::rank_select", BULK_SIZE, [bits](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			do_not_optimize(IMD::rank_select{ std::span{ *bits } }.count());
+	} });
+	cases.push_back({ "rank_select::rank", 1, [bits, index](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			do_not_optimize(index->rank(i * 7919 % index->size()));
+	} });
+	cases.push_back({ "rank_select::select", 1, [bits, index](size_t iterations) {
+		for (size_t i{ 0 }; i < iterations; ++i)
+			do_not_optimize(index->select(i * 7919 % index->count()));
+	} });
+}
+
+// Calls <c> in batches of doubling size until one batch takes at least <min_time> and reports that batch
+bench_result measure(const bench_case& c, std::chrono::nanoseconds min_time) {
+	c.run(1);
+
+	for (size_t iterations{ 1 };; iterations *= 2) {
+		size_t allocations_before = allocations::count.load(std::memory_order_relaxed);
+		auto cycles_before = cycles();
+		auto start = std::chrono::steady_clock::now();
+		c.run(iterations);
+		auto stop = std::chrono::steady_clock::now();
+		auto elapsed_cycles = cycles() - cycles_before;
+		size_t allocations_after = allocations::count.load(std::memory_order_relaxed);
+
+		if (stop - start >= min_time || iterations >= (size_t{ 1 } << 40)) {
+			auto n = static_cast<double>(iterations);
+			return {
+				c.name,
+				c.bytes,
+				std::chrono::duration<double, std::nano>(stop - start).count() / n,
+				elapsed_cycles == 0 ? 0.0 : static_cast<double>(c.bytes) * n / static_cast<double>(elapsed_cycles),
+				static_cast<double>(allocations_after - allocations_before) / n
+			};
+		}
+	}
+}
+
+// Writes <results> as a JSON array with one case per line
+void write_json(std::ostream& out, const std::vector<bench_result>& results) {
+	out << "[\n";
+	for (size_t i{ 0 }; i < results.size(); ++i) {
+		const auto& r = results[i];
+		char line[512];
+		std::snprintf(line, sizeof(line), "  {\"name\": \"%s\", \"bytes\": %zu, \"ns_per_op\": %.3f, \"bytes_per_cycle\": %.4f, \"allocations_per_op\": %.3f}%s\n",
+			r.name.c_str(), r.bytes, r.ns_per_op, r.bytes_per_cycle, r.allocations_per_op, i + 1 < results.size() ? "," : "");
+		out << line;
+	}
+	out << "]\n";
+}
+
+// Reads the time per call of every case from a file written by write_json, keyed by name and size
+std::map<std::pair<std::string, size_t>, double> read_baseline(std::istream& in) {
+	std::map<std::pair<std::string, size_t>, double> baseline;
+	std::string line;
+
+	auto number_after = [&line](std::string_view key) {
+		auto position = line.find(key);
+		return position == std::string::npos ? 0.0 : std::strtod(line.c_str() + position + key.size(), nullptr);
+	};
+
+	while (std::getline(in, line)) {
+		constexpr std::string_view NAME_KEY{ "\"name\": \"" };
+		auto name_start = line.find(NAME_KEY);
+		if (name_start == std::string::npos)
+			continue;
+		name_start += NAME_KEY.size();
+		auto name_end = line.find('"', name_start);
+
+		auto bytes = static_cast<size_t>(number_after("\"bytes\": "));
+		baseline[{ line.substr(name_start, name_end - name_start), bytes }] = number_after("\"ns_per_op\": ");
+	}
+
+	return baseline;
+}
+
+int main(int argc, char** argv) {
+	std::string filter;
+	std::string json_path;
+	std::string baseline_path;
+	std::chrono::nanoseconds min_time = std::chrono::milliseconds{ 10 };
+
+	for (int i{ 1 }; i < argc; i += 2) {
+		std::string_view option{ argv[i] };
+		if (i + 1 >= argc) {
+			std::fprintf(stderr, "usage: %s [--filter <text>] [--min-time <ms>] [--json <file>] [--baseline <file>]\n", argv[0]);
+			return 2;
+		}
+
+		if (option == "--filter")
+			filter = argv[i + 1];
+		else if (option == "--min-time")
+			min_time = std::chrono::milliseconds{ std::atoi(argv[i + 1]) };
+		else if (option == "--json")
+			json_path = argv[i + 1];
+		else if (option == "--baseline")
+			baseline_path = argv[i + 1];
+		else {
+			std::fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	std::map<std::pair<std::string, size_t>, double> baseline;
+	if (!baseline_path.empty()) {
+		std::ifstream in{ baseline_path };
+		if (!in) {
+			std::fprintf(stderr, "cannot read %s\n", baseline_path.c_str());
+			return 1;
+		}
+		baseline = read_baseline(in);
+	}
+
+	IMD::file_descriptor null_device{ -1 };
+#if __has_include(<fcntl.h>)
+	null_device.fd = open("/dev/null", O_WRONLY);
+#endif
+
+	std::vector<bench_case> cases;
+	add_format_cases<1>(cases, null_device);
+	add_format_cases<2>(cases, null_device);
+	add_format_cases<4>(cases, null_device);
+	add_format_cases<8>(cases, null_device);
+	add_format_cases<16>(cases, null_device);
+	add_format_cases<64>(cases, null_device);
+	add_format_cases<256>(cases, null_device);
+	add_format_cases<4096>(cases, null_device);
+	add_format_cases<TEXT_OBJECT_SIZE>(cases, null_device);
+	add_object_cases<1>(cases);
+	add_object_cases<2>(cases);
+	add_object_cases<4>(cases);
+	add_object_cases<8>(cases);
+	add_object_cases<16>(cases);
+	add_object_cases<64>(cases);
+	add_object_cases<256>(cases);
+	add_object_cases<4096>(cases);
+	add_bulk_cases(cases);
+	add_bit_vector_cases(cases);
+	add_rank_select_cases(cases);
+	add_decode_cases(cases, 1);
+	add_decode_cases(cases, 10);
+	add_decode_cases(cases, 50);
+	add_patch_cases(cases, false);
+	add_patch_cases(cases, true);
+	add_check_cases(cases);
+	add_record_cases(cases);
+#if __has_include(<sys/mman.h>)
+	add_mapped_cases(cases);
+#endif
+	add_parallel_cases(cases);
+	add_unpack_cases(cases);
+	add_hexdump_cases(cases, null_device);
+
+	IMD::cpu::report(std::cout);
+	std::cout.flush();
+
+	std::printf("%-32s %8s %12s %12s %10s%s\n", "function", "bytes", "ns/op", "bytes/cycle", "allocs/op", baseline.empty() ? "" : "   speedup");
+
+	std::vector<bench_result> results;
+	for (const auto& c : cases) {
+		if (!filter.empty() && c.name.find(filter) == std::string::npos)
+			continue;
+
+		auto r = measure(c, min_time);
+		std::printf("%-32s %8zu %12.2f %12.3f %10.2f", r.name.c_str(), r.bytes, r.ns_per_op, r.bytes_per_cycle, r.allocations_per_op);
+		if (auto it = baseline.find({ r.name, r.bytes }); it != baseline.end() && r.ns_per_op > 0)
+			std::printf("   %6.2fx", it->second / r.ns_per_op);
+		std::printf("\n");
+		std::fflush(stdout);
+
+		results.push_back(std::move(r));
+	}
+
+	if (!json_path.empty()) {
+		std::ofstream out{ json_path };
+		write_json(out, results);
+		if (!out) {
+			std::fprintf(stderr, "cannot write %s\n", json_path.c_str());
+			return 1;
+		}
+	}
+}
@@ -13,17 +13,96 @@ Unlike unsigned char, which is an integral type and can be used in arithmetic, s
 (2). Bit numbering
 
 This library treats the object memory as a contiguous array of bytes in little-endian order. Bits within each byte are numbered from right to left (from the least significant bit at position 0 on the right, to the most significant bit at position 7 on the left).
+
+(3). Contiguous ranges
+
+Every operation that accepts a single object also has an overload accepting a std::span. The bytes of all the elements of the span are treated as one object,
+so bit numbering continues from one element to the next and the work is done by the same word-wise and SIMD kernels over the whole range.
+
+(4). Compile time
+
+one_bit_count, zero_bit_count, is_power_of_two, the all/any predicates, the bit range functions, the bit searches, extract_bits, deposit_bits, invert_bits, byte_swap and the shifts and rotations are constexpr
+for trivially copyable types.
+Objects of 1, 2, 4, 8 or 16 bytes are processed as a single unsigned integer (std::popcount, a byte swap, a native shift), other sizes one 64-bit word at a time.
+
+(5). Runtime dispatch
+
+The SIMD kernels are compiled for their instruction sets with target attributes, so the header needs no -m flags and one binary runs on any x86 CPU.
+IMD::cpu detects the CPU features once and binds every kernel to the widest implementation they allow; IMD::cpu::report lists the choices.
+Setting the environment variable IMD_FORCE_SCALAR=1 forces the portable scalar kernels everywhere.
+
+(6). Checks
+
+modify_byte, modify_bit and restore_value throw std::runtime_error for an index or a range outside the value. Their *_unchecked variants only assert,
+and their try_* variants return std::errc (or std::expected where the standard library has it) instead of throwing.
+Defining IMD_UNCHECKED before including the header turns the checks of the throwing versions into debug assertions too.
+Without exceptions (-fno-exceptions) every failed check writes its message to stderr and aborts.
+
+(7). Mapped files
+
+On POSIX systems IMD::mapped_bytes maps a file read-only or read-write with mmap, so the span overloads work on files larger than memory
+without copying them. Changes to a read-write mapping are written back with sync(), which calls msync.
+
+(8). Parallel execution
+
+The counts, the all/any predicates, find_first_set, find_first_zero, invert_bits and the in-place combinators of spans accept IMD::seq, IMD::par
+or IMD::par_unseq as their first argument. The parallel policies split the range into 256 KiB chunks that a shared pool of threads takes in turn.
+The predicates and searches skip the remaining chunks once their answer is known.
+
+(9). Hexdump
+
+IMD::hexdump writes an object or a span in the layout of xxd: an offset, the bytes in hexadecimal in groups, and their printable characters.
+The width, the group size and the first offset are set with IMD::hexdump_options, and runs of identical lines are squeezed into a "*" line.
 */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IMD_X86_SIMD 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 using namespace std::string_literals;
 
 namespace IMD {
@@ -31,411 +110,5267 @@ namespace IMD {
 	// The number of bits in one byte
 	constexpr size_t BITS_PER_BYTE{ 8 };
 
-	// Returns the number of bytes of the specified type <T>
-	template<typename T>
-	constexpr size_t byte_count() noexcept {
-		return sizeof(T);
-	}
+	// A field of a structure, given by its offset and size in bytes, for byte order conversions that swap each field on its own
+	struct field {
+		size_t offset;
+		size_t size;
+	};
 
-	// Returns the number of bits of the specified type <T>
-	template<typename T>
-	constexpr size_t bit_count() noexcept {
-		return sizeof(T) * BITS_PER_BYTE;
-	}
+	// A new value for the byte at <index>, for modify_bytes
+	struct byte_edit {
+		size_t index;
+		std::byte value;
+	};
 
-	// Prints the bytes of <value> in hexadecimal format without a trailing newline
-	template<typename T>
-	void print_hex_bytes(const T& value, const std::string& separator = " "s) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			std::cout << "0x" << std::setw(2) << std::setfill('0') << std::hex << static_cast<short>(static_cast<unsigned char>(ptr[i])) << separator;
-	}
+	// A new value for the bit at <index>, for modify_bits
+	struct bit_edit {
+		size_t index;
+		bool value;
+	};
 
-	// Prints the bytes of <value> in decimal format without a trailing newline
-	template<typename T>
-	void print_dec_bytes(const T& value, const std::string& separator = " "s) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			std::cout << static_cast<short>(static_cast<unsigned char>(ptr[i])) << separator;
-	}
+	// Returned by the search functions when there is no such bit
+	constexpr size_t npos{ static_cast<size_t>(-1) };
 
-	// Prints the bytes of <value> in octal format without a trailing newline
-	template<typename T>
-	void print_oct_bytes(const T& value, const std::string& separator = " "s) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			std::cout << "0" << std::setw(3) << std::setfill('0') << std::oct << static_cast<short>(static_cast<unsigned char>(ptr[i])) << separator;
-	}
+	// A POSIX file descriptor the print functions can write to instead of a stream
+	struct file_descriptor {
+		int fd;
+	};
 
-	// Prints the bytes of <value> in binary format without a trailing newline
-	template<typename T>
-	void print_bin_bytes(const T& value, const std::string& separator = " "s){
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			unsigned char byte = static_cast<unsigned char>(ptr[i]);
-			std::cout << "0b";
-			for (size_t j{BITS_PER_BYTE}; j-- > 0; )
-				std::cout << ((byte >> j) & 1);
-			std::cout << separator;
+	// The layout of the lines written by hexdump: <width> bytes per line as hexadecimal digits in groups of <group> bytes
+	// (no spaces if 0), then as characters. The offset printed for the first byte is <offset>. With <squeeze>, a run of
+	// lines equal to the one before them is written as a single "*" line
+	struct hexdump_options {
+		size_t width{ 16 };
+		size_t group{ 2 };
+		size_t offset{ 0 };
+		bool squeeze{ true };
+	};
+
+	// Execution policies for the bulk span operations, in the manner of std::execution. seq runs on the calling thread; par and
+	// par_unseq split the range into chunks that the threads of a shared pool process, with at most <threads> threads taking
+	// part, or every hardware thread if it is 0. The kernels already use SIMD, so par_unseq behaves like par
+	struct sequenced_policy {};
+
+	struct parallel_policy {
+		size_t threads{ 0 };
+	};
+
+	struct parallel_unsequenced_policy {
+		size_t threads{ 0 };
+	};
+
+	inline constexpr sequenced_policy seq{};
+	inline constexpr parallel_policy par{};
+	inline constexpr parallel_unsequenced_policy par_unseq{};
+
+	// Runtime CPU feature detection. The features are detected once, on first use, and every SIMD kernel of the library
+	// is bound to the widest implementation they allow. Setting the environment variable IMD_FORCE_SCALAR to anything
+	// but "0" before the first call makes every kernel use its portable scalar implementation
+	namespace cpu {
+
+		// The instruction set extensions the kernels have implementations for, from the narrowest to the widest
+		enum class isa {
+			scalar,
+			popcnt,
+			bmi2,
+			avx2,
+			avx512
+		};
+
+		// The kernels that are dispatched at runtime
+		enum class kernel {
+			popcount,
+			invert,
+			combine,
+			combine_popcount,
+			all_bytes_equal,
+			reverse,
+			byte_swap,
+			shift,
+			expand_bits,
+			select_in_word,
+			find_bit,
+			decode_bits,
+			extract_deposit,
+			unpack_bits,
+			pack_bits
+		};
+
+		// The number of enumerators of <kernel>
+		constexpr size_t KERNEL_COUNT{ 15 };
+
+		// The instruction set extensions of the CPU the library cares about
+		struct features {
+			bool sse42;
+			bool popcnt;
+			bool bmi2;
+			bool avx2;
+			bool avx512f;
+			bool avx512bw;
+			bool avx512_vpopcntdq;
+			bool avx512vbmi2;
+			bool fast_pdep; // PDEP and PEXT run in hardware, rather than in microcode as on AMD CPUs before Zen 3
+		};
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		// Returns true if the CPU is an AMD one older than Zen 3 (family 19h), whose PDEP and PEXT take a cycle per bit of the mask
+		inline bool microcoded_pdep() noexcept {
+			unsigned eax{ 0 }, ebx{ 0 }, ecx{ 0 }, edx{ 0 };
+			if (!__builtin_cpu_is("amd") || !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+				return false;
+
+			unsigned family{ (eax >> 8) & 0xF };
+			if (family == 0xF)
+				family += (eax >> 20) & 0xFF;
+			return family < 0x19;
 		}
-	}
+#endif
 
-	// Print the bits of <value> without a trailing newline
-	template<typename T>
-	void print_bits(const T& value, const std::string& separator = " "s) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			for (size_t j{ BITS_PER_BYTE }; j-- > 0; )
-				std::cout << (((static_cast<unsigned char>(ptr[i]) >> j) & 1));
-			std::cout << separator;
+		// Queries the CPU for its features
+		inline features detect() noexcept {
+			features result{};
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+			__builtin_cpu_init();
+			result.sse42 = __builtin_cpu_supports("sse4.2");
+			result.popcnt = __builtin_cpu_supports("popcnt");
+			result.bmi2 = __builtin_cpu_supports("bmi2");
+			result.avx2 = __builtin_cpu_supports("avx2");
+			result.avx512f = __builtin_cpu_supports("avx512f");
+			result.avx512bw = __builtin_cpu_supports("avx512bw");
+			result.avx512_vpopcntdq = __builtin_cpu_supports("avx512vpopcntdq");
+			result.avx512vbmi2 = __builtin_cpu_supports("avx512vbmi2");
+			result.fast_pdep = result.bmi2 && !microcoded_pdep();
+#endif
+			return result;
 		}
-	}
 
-	// Prints the bytes of <value> in hexadecimal format followed by a newline
-	template<typename T>
-	void println_hex_bytes(const T& value, const std::string& separator = " "s) {
-		print_hex_bytes(value, separator);
-		std::cout << std::endl;
-	}
+		// Returns true if the IMD_FORCE_SCALAR environment variable asks for the scalar kernels
+		inline bool scalar_forced() noexcept {
+			static const bool forced = [] {
+				const char* value = std::getenv("IMD_FORCE_SCALAR");
+				return value != nullptr && *value != '\0' && std::string_view{ value } != "0";
+			}();
+			return forced;
+		}
 
-	// Prints the bytes of <value> in decimal format followed by a newline
-	template<typename T>
-	void println_dec_bytes(const T& value, const std::string& separator = " "s) {
-		print_dec_bytes(value, separator);
-		std::cout << std::endl;
-	}
-	
-	// Prints the bytes of <value> in octal format followed by a newline
-	template<typename T>
-	void println_oct_bytes(const T& value, const std::string& separator = " "s) {
-		print_oct_bytes(value, separator);
-		std::cout << std::endl;
-	}
+		// Returns the features the kernels are allowed to use: the detected ones, or none if the scalar path is forced
+		inline const features& supported() noexcept {
+			static const features result = scalar_forced() ? features{} : detect();
+			return result;
+		}
 
-	// Prints the bytes of <value> in binary format followed by a newline
-	template<typename T>
-	void println_bin_bytes(const T& value, const std::string& separator = " "s){
-		print_bin_bytes(value, separator);
-		std::cout << std::endl;
-	}
+		// Returns the widest implementation of <k> that the features <f> allow
+		constexpr isa select(kernel k, const features& f) noexcept {
+			switch (k) {
+			case kernel::popcount:
+			case kernel::combine_popcount:
+				if (f.avx512f && f.avx512_vpopcntdq && f.popcnt)
+					return isa::avx512;
+				if (f.avx2 && f.popcnt)
+					return isa::avx2;
+				return f.popcnt ? isa::popcnt : isa::scalar;
+			case kernel::combine:
+				if (f.avx512f)
+					return isa::avx512;
+				return f.avx2 ? isa::avx2 : isa::scalar;
+			case kernel::select_in_word:
+			case kernel::extract_deposit:
+				return f.bmi2 && f.fast_pdep ? isa::bmi2 : isa::scalar;
+			case kernel::decode_bits:
+				if (f.avx512f && f.avx512bw && f.avx512vbmi2 && f.popcnt)
+					return isa::avx512;
+				return f.bmi2 ? isa::bmi2 : isa::scalar;
+			case kernel::unpack_bits:
+			case kernel::pack_bits:
+				if (f.avx512f && f.avx512bw)
+					return isa::avx512;
+				return f.avx2 ? isa::avx2 : isa::scalar;
+			default:
+				return f.avx2 ? isa::avx2 : isa::scalar;
+			}
+		}
 
-	// Prints the bits of <value> followed by a newline
-	template<typename T>
-	void println_bits(const T& value, const std::string& separator = " "s) {
-		print_bits(value, separator);
-		std::cout << std::endl;
-	}
+		// Returns the implementation <k> is bound to on this CPU
+		inline isa implementation(kernel k) noexcept {
+			static const auto table = [] {
+				std::array<isa, KERNEL_COUNT> result{};
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+				for (size_t i{ 0 }; i < KERNEL_COUNT; ++i)
+					result[i] = select(static_cast<kernel>(i), supported());
+#endif
+				return result;
+			}();
+			return table[static_cast<size_t>(k)];
+		}
 
-	// Changes the byte of the supplied <value> with the specified <index>
-	template<typename T>
-	void modify_byte(T& value, size_t index, std::byte new_byte) {
-		if (index >= sizeof(T))
-			throw std::runtime_error("Byte index is outside the size of the value");
+		// Returns the name of <value>
+		constexpr std::string_view name(isa value) noexcept {
+			constexpr std::array<std::string_view, 5> NAMES{ "scalar", "popcnt", "bmi2", "avx2", "avx512" };
+			return NAMES[static_cast<size_t>(value)];
+		}
+
+		// Returns the name of <value>
+		constexpr std::string_view name(kernel value) noexcept {
+			constexpr std::array<std::string_view, KERNEL_COUNT> NAMES{
+				"popcount", "invert", "combine", "combine_popcount", "all_bytes_equal", "reverse", "byte_swap", "shift", "expand_bits", "select_in_word", "find_bit", "decode_bits", "extract_deposit", "unpack_bits",
+				"pack_bits" };
+			return NAMES[static_cast<size_t>(value)];
+		}
+
+		// Writes the detected features and the implementation every kernel is bound to to <os>
+		inline void report(std::ostream& os) {
+			const features detected = detect();
+			os << "cpu features:";
+			for (auto [present, feature] : { std::pair{ detected.sse42, "sse4.2" }, std::pair{ detected.popcnt, "popcnt" },
+				std::pair{ detected.bmi2, "bmi2" }, std::pair{ detected.avx2, "avx2" }, std::pair{ detected.avx512f, "avx512f" },
+				std::pair{ detected.avx512bw, "avx512bw" }, std::pair{ detected.avx512_vpopcntdq, "avx512vpopcntdq" },
+				std::pair{ detected.avx512vbmi2, "avx512vbmi2" }, std::pair{ detected.fast_pdep, "fast-pdep" } })
+				if (present)
+					os << ' ' << feature;
+			if (scalar_forced())
+				os << " (IMD_FORCE_SCALAR is set)";
+			os << '\n';
+
+			for (size_t i{ 0 }; i < KERNEL_COUNT; ++i)
+				os << "  " << name(static_cast<kernel>(i)) << ": " << name(implementation(static_cast<kernel>(i))) << '\n';
+		}
 
-		auto bytes = reinterpret_cast<std::byte*>(&value);
-		bytes[index] = new_byte;
 	}
 
-	// Changes the bit of the supplied <value> at the specified <index> to <new_bit>
-	template<typename T>
-	void modify_bit(T& value, size_t index, bool new_bit) {
-		if (index >= sizeof(T) * BITS_PER_BYTE)
-			throw std::runtime_error("Byte index is outside the size of the value");
+	namespace detail {
 
-		auto ptr = reinterpret_cast<std::byte*>(&value);
-		size_t byte_index{ index / BITS_PER_BYTE };
-		size_t bit_index{ index % BITS_PER_BYTE };
+		// Ranges of at least this many bytes are processed with the SIMD kernels when the CPU supports them
+		constexpr size_t SIMD_THRESHOLD{ 64 };
 
-		auto byte = static_cast<unsigned char>(ptr[byte_index]);
-		if (new_bit)
-			byte |= (1 << bit_index);
-		else
-			byte &= ~(1 << bit_index);
+		// Ranges of at least this many bytes are counted with the SIMD kernels when the CPU supports them
+		constexpr size_t SIMD_POPCOUNT_THRESHOLD{ 256 };
 
-		ptr[byte_index] = static_cast<std::byte>(byte);
-	}
+		// Reports a failed check by throwing an <Exception> made from <args>. When exceptions are disabled (-fno-exceptions) it
+		// writes the message of the exception to stderr and aborts instead, so the header can be used in such builds
+		template<typename Exception, typename... Args>
+		[[noreturn]] void raise(Args&&... args) {
+#if defined(__cpp_exceptions)
+			throw Exception(std::forward<Args>(args)...);
+#else
+			std::fprintf(stderr, "%s\n", Exception(std::forward<Args>(args)...).what());
+			std::abort();
+#endif
+		}
 
-	// Compares the bytes of two values <first> and <second>
-	template<typename T>
-	int compare_bytes(const T& first, const T& second) {
-		return memcmp(&first, &second, sizeof(T));
-	}
+		// Checks that <index> is below <size>, raising std::runtime_error with <message> if it is not. With IMD_UNCHECKED defined
+		// before the header is included the check is a debug assertion instead, which makes the checked operations as cheap as
+		// their unchecked variants
+		inline void check_index(size_t index, size_t size, [[maybe_unused]] const char* message) {
+#ifdef IMD_UNCHECKED
+			assert(index < size && "Index is outside the size of the value");
+#else
+			if (index >= size)
+				raise<std::runtime_error>(message);
+#endif
+		}
 
-	// Swaps the bytes of the given values: <first> and <second>
-	template<typename T>
-	void swap_bytes(T& first, T& second) {
-		auto ptr1 = reinterpret_cast<std::byte*>(&first);
-		auto ptr2 = reinterpret_cast<std::byte*>(&second);
+		// The implementations of one kernel indexed by cpu::isa, nullptr where there is none
+		template<typename F>
+		using kernel_set = std::array<F*, 5>;
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			std::swap(ptr1[i], ptr2[i]);
-	}
+		// Returns the widest implementation of <kernels> that is not wider than <level>
+		template<typename F>
+		F* select_kernel(cpu::isa level, const kernel_set<F>& kernels) noexcept {
+			for (auto i = static_cast<size_t>(level); i > 0; --i)
+				if (kernels[i] != nullptr)
+					return kernels[i];
+			return kernels[0];
+		}
 
-	// Returns a string representation of the bytes of <value> with a <separator>
-	template<typename T>
-	std::string bytes_to_string(const T& value, const std::string& separator = " "s) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		std::string result;
+		// The unsigned integer type with exactly <Size> bytes, or void if there is none
+		template<size_t Size> struct native_word { using type = void; };
+		template<> struct native_word<1> { using type = std::uint8_t; };
+		template<> struct native_word<2> { using type = std::uint16_t; };
+		template<> struct native_word<4> { using type = std::uint32_t; };
+		template<> struct native_word<8> { using type = std::uint64_t; };
+#ifdef __SIZEOF_INT128__
+		__extension__ template<> struct native_word<16> { using type = unsigned __int128; };
+#endif
 
-		result.reserve(sizeof(T) * BITS_PER_BYTE);
+		template<typename T>
+		using native_word_t = typename native_word<sizeof(T)>::type;
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			result.append(std::to_string(static_cast<unsigned char>(ptr[i])));
-			result.append(separator);
+		// Types whose bytes can be read at compile time through std::bit_cast
+		template<typename T>
+		concept bit_castable = std::is_trivially_copyable_v<T>;
+
+		// Types whose bytes can also be written back at compile time through std::bit_cast
+		template<typename T>
+		concept bit_cast_assignable = bit_castable<T> && std::is_copy_assignable_v<T>;
+
+		// Types that can be processed as a single unsigned integer: native integer operations on it follow the library bit numbering
+		// only on little-endian hosts
+		template<typename T>
+		concept natively_sized = bit_castable<T> && !std::is_void_v<native_word_t<T>> && std::endian::native == std::endian::little;
+
+		template<typename T>
+		concept natively_assignable = natively_sized<T> && bit_cast_assignable<T>;
+
+		template<typename T> struct is_span : std::false_type {};
+		template<typename T, size_t Extent> struct is_span<std::span<T, Extent>> : std::true_type {};
+
+		// Types whose own bytes are operated on, as opposed to std::span, whose overloads operate on the bytes of the elements
+		template<typename T>
+		concept single_object = !is_span<std::remove_cv_t<T>>::value;
+
+		// Returns the object representation of <value> as an array of bytes
+		template<bit_castable T>
+		constexpr std::array<std::byte, sizeof(T)> to_byte_array(const T& value) noexcept {
+			return std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
 		}
-		return result;
-	}
 
-	// Returns a string representation of the bits of <value> with a <separator>
-	template<typename T>
-	std::string bits_to_string(const T& value, const std::string& separator = " "s) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		std::string result;
+		// Reverses the byte order of <word>, which compiles to a single BSWAP (or a rotate for 2 bytes)
+		template<typename U>
+		constexpr U byteswap(U word) noexcept {
+			if constexpr (sizeof(U) == 1)
+				return word;
+#ifdef __SIZEOF_INT128__
+			else if constexpr (sizeof(U) == 16)
+				return (static_cast<U>(byteswap(static_cast<std::uint64_t>(word))) << 64) | byteswap(static_cast<std::uint64_t>(word >> 64));
+#endif
+#if defined(__GNUC__)
+			else if constexpr (sizeof(U) == 2)
+				return __builtin_bswap16(word);
+			else if constexpr (sizeof(U) == 4)
+				return __builtin_bswap32(word);
+			else
+				return __builtin_bswap64(word);
+#else
+			else {
+				U result{ 0 };
+				for (size_t i{ 0 }; i < sizeof(U); ++i, word >>= BITS_PER_BYTE)
+					result = static_cast<U>((result << BITS_PER_BYTE) | (word & 0xFF));
+				return result;
+			}
+#endif
+		}
 
-		result.reserve(sizeof(T) * BITS_PER_BYTE);
+		// Loads an unaligned 64-bit word starting at <ptr>; the byte at <ptr> is the least significant one
+		constexpr std::uint64_t load_word(const std::byte* ptr) noexcept {
+			if (std::is_constant_evaluated()) {
+				std::uint64_t word{ 0 };
+				for (size_t i{ 0 }; i < sizeof(word); ++i)
+					word |= static_cast<std::uint64_t>(ptr[i]) << (i * BITS_PER_BYTE);
+				return word;
+			}
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			for (size_t j{ 0 }; j < BITS_PER_BYTE; ++j)
-				result.append(std::to_string((static_cast<unsigned char>(ptr[i]) >> j) & 1));
-			result.append(separator);
+			std::uint64_t word;
+			std::memcpy(&word, ptr, sizeof(word));
+			if constexpr (std::endian::native == std::endian::big)
+				word = byteswap(word);
+			return word;
 		}
-		return result;
-	}
 
-	// Converts the bytes of <value> into a container
-	template<typename T, typename C = std::vector<short>>
-	C bytes_to_container(const T& value) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
+		// Stores the 64-bit <word> at the unaligned <ptr>; the least significant byte goes to <ptr>
+		constexpr void store_word(std::byte* ptr, std::uint64_t word) noexcept {
+			if (std::is_constant_evaluated()) {
+				for (size_t i{ 0 }; i < sizeof(word); ++i)
+					ptr[i] = static_cast<std::byte>(word >> (i * BITS_PER_BYTE));
+				return;
+			}
 
-		C container{};
-		auto it = std::back_inserter(container);
+			if constexpr (std::endian::native == std::endian::big)
+				word = byteswap(word);
+			std::memcpy(ptr, &word, sizeof(word));
+		}
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			*it = static_cast<typename C::value_type>(static_cast<unsigned char>(ptr[i]));
+		// Counts the bits set to 1 in <size> bytes starting at <ptr>, one 64-bit word at a time with a byte tail
+		constexpr size_t popcount_scalar(const std::byte* ptr, size_t size) noexcept {
+			size_t count{ 0 };
+			size_t i{ 0 };
 
-		return container;
-	}
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+				count += std::popcount(load_word(ptr + i));
 
-	// Converts the bits of <value> into a container
-	template<typename T, typename C = std::vector<bool>>
-	C bits_to_container(const T& value) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
+			for (; i < size; ++i)
+				count += std::popcount(static_cast<unsigned char>(ptr[i]));
 
-		C container{};
-		auto it = std::back_inserter(container);
+			return count;
+		}
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			for (size_t j{ 0 }; j < BITS_PER_BYTE; ++j)
-				*it = (static_cast<unsigned char>(ptr[i]) >> j) & 1;
+#ifdef IMD_X86_SIMD
+		// Same as popcount_scalar, but compiled so that std::popcount becomes the POPCNT instruction once the scalar kernel is inlined
+		__attribute__((target("popcnt")))
+		inline size_t popcount_popcnt(const std::byte* ptr, size_t size) noexcept {
+			return popcount_scalar(ptr, size);
+		}
 
-		return container;
-	}
+		// Returns the number of bits set to 1 in each 64-bit lane of <block>, using a nibble lookup table (PSHUFB) summed by PSADBW
+		__attribute__((target("avx2")))
+		inline __m256i popcount_lanes_avx2(__m256i block) noexcept {
+			const __m256i lookup = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const __m256i low_mask = _mm256_set1_epi8(0x0f);
 
-	// Inverts (bitwise NOT) all bits in <value>
-	template<typename T>
-	void invert_bits(T& value) {
-		auto ptr = reinterpret_cast<std::byte*>(&value);
+			__m256i low = _mm256_and_si256(block, low_mask);
+			__m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_mask);
+			__m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+			return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+		}
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			ptr[i] = static_cast<std::byte>(~static_cast<unsigned char>(ptr[i]));
-	}
+		// Returns the sum of the four 64-bit lanes of <lanes>
+		__attribute__((target("avx2")))
+		inline size_t sum_lanes_avx2(__m256i lanes) noexcept {
+			return static_cast<size_t>(_mm256_extract_epi64(lanes, 0)) + static_cast<size_t>(_mm256_extract_epi64(lanes, 1))
+				+ static_cast<size_t>(_mm256_extract_epi64(lanes, 2)) + static_cast<size_t>(_mm256_extract_epi64(lanes, 3));
+		}
 
-	// Return the number of bits set to 1 in <value>
-	template<typename T>
-	size_t one_bit_count(const T& value) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		size_t count{ 0 };
+		// Returns the sum of the eight 64-bit lanes of <lanes>
+		__attribute__((target("avx512f")))
+		inline size_t sum_lanes_avx512(__m512i lanes) noexcept {
+			std::uint64_t values[8];
+			_mm512_storeu_si512(values, lanes);
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			auto byte = static_cast<unsigned char>(ptr[i]);
-			while (byte) {
-				count += byte & 1;
-				byte >>= 1;
-			}
+			size_t sum{ 0 };
+			for (auto value : values)
+				sum += static_cast<size_t>(value);
+			return sum;
 		}
 
-		return count;
-	}
+		// Counts 32 bytes per iteration with popcount_lanes_avx2
+		__attribute__((target("avx2,popcnt")))
+		inline size_t popcount_avx2(const std::byte* ptr, size_t size) noexcept {
+			__m256i total = _mm256_setzero_si256();
+			size_t i{ 0 };
 
-	// Return the number of bits set to 0 in <value>
-	template<typename T>
-	size_t zero_bit_count(const T& value) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		size_t count{ 0 };
+			for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i))
+				total = _mm256_add_epi64(total, popcount_lanes_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i))));
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			auto byte = static_cast<unsigned char>(ptr[i]);
-			for (unsigned char j{ 0 }; j < BITS_PER_BYTE; ++j)
-				if ((byte & (1 << j)) == 0)
-					++count;
+			return sum_lanes_avx2(total) + popcount_popcnt(ptr + i, size - i);
 		}
 
-		return count;
-	}
+		// Counts 64 bytes per iteration with VPOPCNTQ
+		__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+		inline size_t popcount_avx512(const std::byte* ptr, size_t size) noexcept {
+			__m512i total = _mm512_setzero_si512();
+			size_t i{ 0 };
 
-	// Returns true if <value> has exactly one bit set to 1, indicating it is a power of two
-	template<typename T>
-	bool is_power_of_two(const T& value) {
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		size_t one_bit_count{ 0 };
+			for (; i + sizeof(__m512i) <= size; i += sizeof(__m512i))
+				total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_loadu_si512(ptr + i)));
+
+			return sum_lanes_avx512(total) + popcount_popcnt(ptr + i, size - i);
+		}
+#endif
+
+		// Counts the bits set to 1 in <size> bytes starting at <ptr>, picking the widest kernel the CPU supports
+		inline size_t popcount(const std::byte* ptr, size_t size) noexcept {
+#ifdef IMD_X86_SIMD
+			using signature = size_t(const std::byte*, size_t);
+			static const auto kernels = [] { // The kernel for small ranges and the one for large ranges, bound together behind one guard
+				auto level = cpu::implementation(cpu::kernel::popcount);
+				return std::array{
+					select_kernel<signature>(std::min(level, cpu::isa::popcnt), { popcount_scalar, popcount_popcnt, nullptr, nullptr, nullptr }),
+					select_kernel<signature>(level, { popcount_scalar, popcount_popcnt, nullptr, popcount_avx2, popcount_avx512 }) };
+			}();
+
+			return kernels[size >= SIMD_POPCOUNT_THRESHOLD](ptr, size);
+#else
+			return popcount_scalar(ptr, size);
+#endif
+		}
+
+#if defined(IMD_X86_SIMD) && !defined(__POPCNT__)
+		// Counts the bits set to 1 in the native unsigned integer <word> with a single POPCNT instruction
+		template<typename U>
+		__attribute__((target("popcnt")))
+		size_t popcount_word_popcnt(U word) noexcept {
+			return static_cast<size_t>(__builtin_popcountll(word));
+		}
+
+		// Returns true if popcount_native may use POPCNT, deciding it on the first call like the kernels that are dispatched
+		inline bool popcnt_word() noexcept {
+			static const bool supported{ cpu::implementation(cpu::kernel::popcount) != cpu::isa::scalar };
+			return supported;
+		}
+#endif
+
+		// Counts the bits set to 1 in the native unsigned integer <word>
+		template<typename U>
+		constexpr size_t popcount_native(U word) noexcept {
+#ifdef __SIZEOF_INT128__
+			if constexpr (sizeof(U) == 16)
+				return popcount_native(static_cast<std::uint64_t>(word)) + popcount_native(static_cast<std::uint64_t>(word >> 64));
+			else
+#endif
+			{
+#if defined(IMD_X86_SIMD) && !defined(__POPCNT__)
+				if (!std::is_constant_evaluated() && popcnt_word()) // Without -mpopcnt std::popcount is a library call
+					return popcount_word_popcnt(word);
+#endif
+				return static_cast<size_t>(std::popcount(word));
+			}
+		}
 
-		for (size_t i{ 0 }; i < sizeof(T); ++i) {
-			auto byte = static_cast<unsigned char>(ptr[i]);
-			while (byte) {
-				one_bit_count += (byte & 1);
-				byte >>= 1;
+		// Returns true if <size> bytes starting at <ptr> contain exactly one bit set to 1
+		constexpr bool is_power_of_two(const std::byte* ptr, size_t size) noexcept {
+			size_t count{ 0 };
+			size_t i{ 0 };
 
-				if (one_bit_count > 1)
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+				count += std::popcount(load_word(ptr + i));
+				if (count > 1)
 					return false;
 			}
+
+			for (; i < size; ++i)
+				count += std::popcount(static_cast<unsigned char>(ptr[i]));
+
+			return count == 1;
 		}
 
-		return one_bit_count == 1;
-	}
+		// Returns the index of the bit set to 1 with the specified <rank> (0 for the lowest) in <word>, which must have more than <rank> bits set
+		constexpr unsigned select_in_word_scalar(std::uint64_t word, unsigned rank) noexcept {
+			for (unsigned i{ 0 }; i < rank; ++i)
+				word &= word - 1; // Clears the lowest bit set to 1
+			return static_cast<unsigned>(std::countr_zero(word));
+		}
 
-	// Restores a value of type <T> from a sequence of bytes in the range [first, last)
-	template <typename T, typename InputIt>
-	T restore_value(InputIt first, InputIt last) {
-		if (std::distance(first, last) < sizeof(T))
-			throw std::runtime_error("Not enough bytes to restore value");
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+		// Same as select_in_word_scalar: depositing 1 << <rank> into the bits set in <word> (PDEP) leaves only the selected one
+		__attribute__((target("bmi,bmi2")))
+		inline unsigned select_in_word_bmi2(std::uint64_t word, unsigned rank) noexcept {
+			return static_cast<unsigned>(_tzcnt_u64(_pdep_u64(std::uint64_t{ 1 } << rank, word)));
+		}
+#endif
 
-		T value;
-		auto ptr = reinterpret_cast<std::byte*>(&value);
-		for (size_t i{ 0 }; i < sizeof(T); ++i, ++first)
-			ptr[i] = static_cast<std::byte>(*first);
+		// Returns the index of the bit set to 1 with the specified <rank> in <word>, with PDEP when the CPU supports it
+		inline unsigned select_in_word(std::uint64_t word, unsigned rank) noexcept {
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+			static const auto kernel = select_kernel<unsigned(std::uint64_t, unsigned)>(
+				cpu::implementation(cpu::kernel::select_in_word), { select_in_word_scalar, nullptr, select_in_word_bmi2, nullptr, nullptr });
+			return kernel(word, rank);
+#else
+			return select_in_word_scalar(word, rank);
+#endif
+		}
 
-		return value;
-	}
+		// Inverts <size> bytes starting at <ptr> one 64-bit word at a time with a byte tail
+		constexpr void invert_scalar(std::byte* ptr, size_t size) noexcept {
+			size_t i{ 0 };
 
-	// Reverses the byte order of a value of type <T> in place
-	template<typename T>
-	void byte_swap(T& value) {
-		auto ptr = reinterpret_cast<std::byte*>(&value);
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+				store_word(ptr + i, ~load_word(ptr + i));
 
-		for (size_t i {0}; i < sizeof(T) / 2; ++i)
-			std::swap(ptr[i], ptr[sizeof(T) - 1 - i]);
-	}
+			for (; i < size; ++i)
+				ptr[i] = ~ptr[i];
+		}
 
-	// Shifts the bits of <value> to the left by <shift> positions
-	template<typename T>
-    void shift_left_bits(T& value, size_t shift) {
-        if (shift == 0) return;
+#ifdef IMD_X86_SIMD
+		// Inverts 32 bytes per iteration
+		__attribute__((target("avx2")))
+		inline void invert_avx2(std::byte* ptr, size_t size) noexcept {
+			const __m256i ones = _mm256_set1_epi8(-1);
+			size_t i{ 0 };
 
-        if (shift >= sizeof(T) * BITS_PER_BYTE) {     // If shift amount is greater or equal to total bits in T, zero the whole object
-            auto ptr = reinterpret_cast<std::byte*>(&value);
+			for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+				auto block = reinterpret_cast<__m256i*>(ptr + i);
+				_mm256_storeu_si256(block, _mm256_xor_si256(_mm256_loadu_si256(block), ones));
+			}
 
-            std::fill(ptr, ptr + sizeof(T), std::byte{0});
+			invert_scalar(ptr + i, size - i);
+		}
+#endif
 
-            return;
-        }
+		// Inverts <size> bytes starting at <ptr>, picking the widest kernel the CPU supports
+		inline void invert(std::byte* ptr, size_t size) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<void(std::byte*, size_t)>(cpu::implementation(cpu::kernel::invert), { invert_scalar, nullptr, nullptr, invert_avx2, nullptr });
+			if (size >= SIMD_THRESHOLD) {
+				bulk(ptr, size);
+				return;
+			}
+#endif
+			invert_scalar(ptr, size);
+		}
 
-        auto ptr = reinterpret_cast<std::byte*>(&value);
-        size_t byte_shift {shift / BITS_PER_BYTE};
-        size_t bit_shift {shift % BITS_PER_BYTE};
+		// Bitwise operations on the words of two objects; <andnot_op> clears from the first operand the bits set in the second
+		struct and_op {
+			template<typename U>
+			static constexpr U apply(U first, U second) noexcept { return static_cast<U>(first & second); }
+#ifdef IMD_X86_SIMD
+			__attribute__((target("avx2"))) static __m256i apply_avx2(__m256i first, __m256i second) noexcept { return _mm256_and_si256(first, second); }
+			__attribute__((target("avx512f"))) static __m512i apply_avx512(__m512i first, __m512i second) noexcept { return _mm512_and_si512(first, second); }
+#endif
+		};
 
-        if (byte_shift > 0) { // Shift bytes to the left by byte_shift positions
-            for (size_t i {0}; i < sizeof(T) - byte_shift; ++i) // Move bytes towards the beginning of the array
-                ptr[i] = ptr[i + byte_shift];
-            
-			for (size_t i {sizeof(T) - byte_shift}; i < sizeof(T); ++i) // Zero-fill the trailing bytes
-                ptr[i] = std::byte{0};
-        }
+		struct or_op {
+			template<typename U>
+			static constexpr U apply(U first, U second) noexcept { return static_cast<U>(first | second); }
+#ifdef IMD_X86_SIMD
+			__attribute__((target("avx2"))) static __m256i apply_avx2(__m256i first, __m256i second) noexcept { return _mm256_or_si256(first, second); }
+			__attribute__((target("avx512f"))) static __m512i apply_avx512(__m512i first, __m512i second) noexcept { return _mm512_or_si512(first, second); }
+#endif
+		};
 
-        if (bit_shift > 0) { // Shift bits inside bytes with carry from the next byte
-            for (size_t i {0}; i < sizeof(T); ++i) { // Iterate bytes from the end to the beginning
-                size_t index = sizeof(T) - 1 - i;
-                unsigned char current = static_cast<unsigned char>(ptr[index]);
-                unsigned char next = (index > 0) ? static_cast<unsigned char>(ptr[index - 1]) : 0;
+		struct xor_op {
+			template<typename U>
+			static constexpr U apply(U first, U second) noexcept { return static_cast<U>(first ^ second); }
+#ifdef IMD_X86_SIMD
+			__attribute__((target("avx2"))) static __m256i apply_avx2(__m256i first, __m256i second) noexcept { return _mm256_xor_si256(first, second); }
+			__attribute__((target("avx512f"))) static __m512i apply_avx512(__m512i first, __m512i second) noexcept { return _mm512_xor_si512(first, second); }
+#endif
+		};
 
-                ptr[index] = static_cast<std::byte>((current << bit_shift) | (next >> (BITS_PER_BYTE - bit_shift)));
-            }
-        }
-    }
+		struct andnot_op {
+			template<typename U>
+			static constexpr U apply(U first, U second) noexcept { return static_cast<U>(first & static_cast<U>(~second)); }
+#ifdef IMD_X86_SIMD
+			__attribute__((target("avx2"))) static __m256i apply_avx2(__m256i first, __m256i second) noexcept { return _mm256_andnot_si256(second, first); }
+			__attribute__((target("avx512f"))) static __m512i apply_avx512(__m512i first, __m512i second) noexcept { return _mm512_ternarylogic_epi64(first, second, first, 0x30); }
+#endif
+		};
 
-	// Shifts the bits of <value> to the right by <shift> positions
-	template<typename T>
-    void shift_right_bits(T& value, size_t shift) {
-        if (shift == 0) return;
+		// Writes <Op> applied to <size> bytes starting at <first> and <second> to <dst>, one 64-bit word at a time; <dst> may be <first> or <second>
+		template<typename Op>
+		constexpr void combine_scalar(std::byte* dst, const std::byte* first, const std::byte* second, size_t size) noexcept {
+			size_t i{ 0 };
 
-        if (shift >= sizeof(T) * BITS_PER_BYTE) { // If shift amount is greater or equal to total bits in T, zero the whole object
-            auto ptr = reinterpret_cast<std::byte*>(&value);
-            std::fill(ptr, ptr + sizeof(T), std::byte{0});
-            return;
-        }
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+				store_word(dst + i, Op::apply(load_word(first + i), load_word(second + i)));
 
-        auto ptr = reinterpret_cast<std::byte*>(&value);
-        size_t byte_shift {shift / BITS_PER_BYTE};
-        size_t bit_shift {shift % BITS_PER_BYTE};
+			for (; i < size; ++i)
+				dst[i] = static_cast<std::byte>(Op::apply(static_cast<unsigned char>(first[i]), static_cast<unsigned char>(second[i])));
+		}
 
-        if (byte_shift > 0) { // Shift bytes to the right by byte_shift positions
-            for (size_t i {sizeof(T)}; i-- > byte_shift; ) // // Move bytes towards the end of the array
-                ptr[i] = ptr[i - byte_shift];
+#ifdef IMD_X86_SIMD
+		// Same as combine_scalar, 32 bytes per iteration
+		template<typename Op>
+		__attribute__((target("avx2")))
+		void combine_avx2(std::byte* dst, const std::byte* first, const std::byte* second, size_t size) noexcept {
+			size_t i{ 0 };
 
-            for (size_t i = 0; i < byte_shift; ++i) // Zero-fill the leading bytes
-                ptr[i] = std::byte{0};
-        }
+			for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), Op::apply_avx2(a, b));
+			}
 
-        if (bit_shift > 0) { // Shift bits inside bytes with carry from the previous byte
-            for (size_t i {0}; i < sizeof(T); ++i) { // Iterate bytes from the beginning to the end
-                unsigned char current = static_cast<unsigned char>(ptr[i]);
-                unsigned char previous = (i + 1 < sizeof(T)) ? static_cast<unsigned char>(ptr[i + 1]) : 0;
+			combine_scalar<Op>(dst + i, first + i, second + i, size - i);
+		}
 
-                ptr[i] = static_cast<std::byte>((current >> bit_shift) | (previous << (BITS_PER_BYTE - bit_shift)));
-            }
-        }
-    }
+		// Same as combine_scalar, 64 bytes per iteration
+		template<typename Op>
+		__attribute__((target("avx512f")))
+		void combine_avx512(std::byte* dst, const std::byte* first, const std::byte* second, size_t size) noexcept {
+			size_t i{ 0 };
 
-	// Returns true if all bits in <value> are set to 1
-	template<typename T>
-	bool all_bits_one(const T& value){
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			for (size_t j{ BITS_PER_BYTE }; j-- > 0; )
-				if (((static_cast<unsigned char>(ptr[i]) >> j) & 1) == 0)
-					return false;
+			for (; i + sizeof(__m512i) <= size; i += sizeof(__m512i))
+				_mm512_storeu_si512(dst + i, Op::apply_avx512(_mm512_loadu_si512(first + i), _mm512_loadu_si512(second + i)));
 
-		return true;
-	}
+			combine_scalar<Op>(dst + i, first + i, second + i, size - i);
+		}
+#endif
 
-	// Returns true if all bits in <value> are set to 0
-	template<typename T>
-	bool all_bits_zero(const T& value){
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			for (size_t j{ BITS_PER_BYTE }; j-- > 0; )
-				if (((static_cast<unsigned char>(ptr[i]) >> j) & 1) == 1)
-					return false;
+		// Writes <Op> applied to <size> bytes starting at <first> and <second> to <dst>, picking the widest kernel the CPU supports
+		template<typename Op>
+		void combine(std::byte* dst, const std::byte* first, const std::byte* second, size_t size) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<void(std::byte*, const std::byte*, const std::byte*, size_t)>(
+				cpu::implementation(cpu::kernel::combine), { combine_scalar<Op>, nullptr, nullptr, combine_avx2<Op>, combine_avx512<Op> });
+			if (size >= SIMD_THRESHOLD) {
+				bulk(dst, first, second, size);
+				return;
+			}
+#endif
+			combine_scalar<Op>(dst, first, second, size);
+		}
 
-		return true;
-	}
+		// Counts the bits set to 1 in <Op> applied to <size> bytes starting at <first> and <second> without storing the result
+		template<typename Op>
+		constexpr size_t combine_popcount_scalar(const std::byte* first, const std::byte* second, size_t size) noexcept {
+			size_t count{ 0 };
+			size_t i{ 0 };
 
-	// Returns true if any bit in <value> is set to 1
-	template<typename T>
-	bool any_bits_one(const T& value){
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			for (size_t j{ BITS_PER_BYTE }; j-- > 0; )
-				if (((static_cast<unsigned char>(ptr[i]) >> j) & 1) == 1)
-					return true;
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+				count += static_cast<size_t>(std::popcount(Op::apply(load_word(first + i), load_word(second + i))));
 
-		return false;
-	}
+			for (; i < size; ++i)
+				count += static_cast<size_t>(std::popcount(Op::apply(static_cast<unsigned char>(first[i]), static_cast<unsigned char>(second[i]))));
 
-	// Returns true if any bit in <value> is set to 0
-	template<typename T>
-	bool any_bits_zero(const T& value){
-		auto ptr = reinterpret_cast<const std::byte*>(&value);
-		
-		for (size_t i{ 0 }; i < sizeof(T); ++i)
-			for (size_t j{ BITS_PER_BYTE }; j-- > 0; )
-				if (((static_cast<unsigned char>(ptr[i]) >> j) & 1) == 0)
-					return true;
+			return count;
+		}
 
-		return false;
-	}
+#ifdef IMD_X86_SIMD
+		// Same as combine_popcount_scalar, compiled for the POPCNT instruction
+		template<typename Op>
+		__attribute__((target("popcnt")))
+		size_t combine_popcount_popcnt(const std::byte* first, const std::byte* second, size_t size) noexcept {
+			return combine_popcount_scalar<Op>(first, second, size);
+		}
+
+		// Same as combine_popcount_scalar, 32 bytes per iteration
+		template<typename Op>
+		__attribute__((target("avx2,popcnt")))
+		size_t combine_popcount_avx2(const std::byte* first, const std::byte* second, size_t size) noexcept {
+			__m256i total = _mm256_setzero_si256();
+			size_t i{ 0 };
+
+			for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + i));
+				total = _mm256_add_epi64(total, popcount_lanes_avx2(Op::apply_avx2(a, b)));
+			}
+
+			return sum_lanes_avx2(total) + combine_popcount_popcnt<Op>(first + i, second + i, size - i);
+		}
+
+		// Same as combine_popcount_scalar, 64 bytes per iteration with VPOPCNTQ
+		template<typename Op>
+		__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+		size_t combine_popcount_avx512(const std::byte* first, const std::byte* second, size_t size) noexcept {
+			__m512i total = _mm512_setzero_si512();
+			size_t i{ 0 };
+
+			for (; i + sizeof(__m512i) <= size; i += sizeof(__m512i))
+				total = _mm512_add_epi64(total, _mm512_popcnt_epi64(Op::apply_avx512(_mm512_loadu_si512(first + i), _mm512_loadu_si512(second + i))));
+
+			return sum_lanes_avx512(total) + combine_popcount_popcnt<Op>(first + i, second + i, size - i);
+		}
+#endif
+
+		// Counts the bits set to 1 in <Op> applied to <size> bytes starting at <first> and <second>, picking the widest kernel the CPU supports
+		template<typename Op>
+		size_t combine_popcount(const std::byte* first, const std::byte* second, size_t size) noexcept {
+#ifdef IMD_X86_SIMD
+			using signature = size_t(const std::byte*, const std::byte*, size_t);
+			static const auto kernels = [] {
+				auto level = cpu::implementation(cpu::kernel::combine_popcount);
+				return std::array{
+					select_kernel<signature>(std::min(level, cpu::isa::popcnt), { combine_popcount_scalar<Op>, combine_popcount_popcnt<Op>, nullptr, nullptr, nullptr }),
+					select_kernel<signature>(level, { combine_popcount_scalar<Op>, combine_popcount_popcnt<Op>, nullptr, combine_popcount_avx2<Op>, combine_popcount_avx512<Op> }) };
+			}();
+
+			return kernels[size >= SIMD_POPCOUNT_THRESHOLD](first, second, size);
+#else
+			return combine_popcount_scalar<Op>(first, second, size);
+#endif
+		}
+
+		// Applies <Op> to <first> and <second> and writes the result to <result>
+		template<typename Op, typename T>
+		constexpr void combine(const T& first, const T& second, T& result) {
+			if constexpr (natively_assignable<T>) {
+				using word_type = native_word_t<T>;
+				result = std::bit_cast<T>(Op::apply(std::bit_cast<word_type>(first), std::bit_cast<word_type>(second)));
+			}
+			else {
+				if constexpr (bit_cast_assignable<T>) {
+					if (std::is_constant_evaluated()) {
+						auto first_bytes = to_byte_array(first);
+						auto second_bytes = to_byte_array(second);
+						combine_scalar<Op>(first_bytes.data(), first_bytes.data(), second_bytes.data(), first_bytes.size());
+						result = std::bit_cast<T>(first_bytes);
+						return;
+					}
+				}
+				combine<Op>(reinterpret_cast<std::byte*>(&result), reinterpret_cast<const std::byte*>(&first), reinterpret_cast<const std::byte*>(&second), sizeof(T));
+			}
+		}
+
+		// Counts the bits set to 1 in <Op> applied to <first> and <second>
+		template<typename Op, typename T>
+		constexpr size_t combine_popcount(const T& first, const T& second) {
+			if constexpr (natively_sized<T>) {
+				using word_type = native_word_t<T>;
+				return popcount_native(Op::apply(std::bit_cast<word_type>(first), std::bit_cast<word_type>(second)));
+			}
+			else {
+				if constexpr (bit_castable<T>) {
+					if (std::is_constant_evaluated()) {
+						auto first_bytes = to_byte_array(first);
+						auto second_bytes = to_byte_array(second);
+						return combine_popcount_scalar<Op>(first_bytes.data(), second_bytes.data(), first_bytes.size());
+					}
+				}
+				return combine_popcount<Op>(reinterpret_cast<const std::byte*>(&first), reinterpret_cast<const std::byte*>(&second), sizeof(T));
+			}
+		}
+
+		// Writes <Op> applied to the bytes of <first> and <second> to the bytes of <result>, which must all have the same size
+		template<typename Op>
+		void combine(std::span<const std::byte> first, std::span<const std::byte> second, std::span<std::byte> result) {
+			if (first.size() != second.size() || first.size() != result.size())
+				raise<std::runtime_error>("Ranges have different sizes");
+
+			combine<Op>(result.data(), first.data(), second.data(), result.size());
+		}
+
+		// Counts the bits set to 1 in <Op> applied to the bytes of <first> and <second>, which must have the same size
+		template<typename Op>
+		size_t combine_popcount(std::span<const std::byte> first, std::span<const std::byte> second) {
+			if (first.size() != second.size())
+				raise<std::runtime_error>("Ranges have different sizes");
+
+			return combine_popcount<Op>(first.data(), second.data(), first.size());
+		}
+
+		// Returns true if every one of <size> bytes starting at <ptr> is equal to <pattern>, comparing one 64-bit word at a time
+		// and stopping at the first word that differs
+		constexpr bool all_bytes_equal_scalar(const std::byte* ptr, size_t size, std::byte pattern) noexcept {
+			const std::uint64_t pattern_word{ static_cast<std::uint64_t>(pattern) * 0x0101010101010101ULL };
+			size_t i{ 0 };
+
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+				if (load_word(ptr + i) != pattern_word)
+					return false;
+
+			for (; i < size; ++i)
+				if (ptr[i] != pattern)
+					return false;
+
+			return true;
+		}
+
+#ifdef IMD_X86_SIMD
+		// Compares 64 bytes per iteration: the differences from <pattern> of two 32-byte blocks are OR-ed and tested with VPTEST
+		__attribute__((target("avx2")))
+		inline bool all_bytes_equal_avx2(const std::byte* ptr, size_t size, std::byte pattern) noexcept {
+			const __m256i pattern_block = _mm256_set1_epi8(static_cast<char>(pattern));
+			size_t i{ 0 };
+
+			for (; i + 2 * sizeof(__m256i) <= size; i += 2 * sizeof(__m256i)) {
+				__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i));
+				__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i + sizeof(__m256i)));
+				__m256i difference = _mm256_or_si256(_mm256_xor_si256(first, pattern_block), _mm256_xor_si256(second, pattern_block));
+				if (!_mm256_testz_si256(difference, difference))
+					return false;
+			}
+
+			return all_bytes_equal_scalar(ptr + i, size - i, pattern);
+		}
+#endif
+
+		// Returns true if every one of <size> bytes starting at <ptr> is equal to <pattern>, picking the widest kernel the CPU supports
+		inline bool all_bytes_equal(const std::byte* ptr, size_t size, std::byte pattern) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<bool(const std::byte*, size_t, std::byte)>(
+				cpu::implementation(cpu::kernel::all_bytes_equal), { all_bytes_equal_scalar, nullptr, nullptr, all_bytes_equal_avx2, nullptr });
+			if (size >= SIMD_THRESHOLD)
+				return bulk(ptr, size, pattern);
+#endif
+			return all_bytes_equal_scalar(ptr, size, pattern);
+		}
+
+		// Returns true if every byte of <value> is equal to <pattern>
+		template<typename T>
+		constexpr bool all_bytes_equal(const T& value, std::byte pattern) noexcept {
+			if constexpr (natively_sized<T>) {
+				using word_type = native_word_t<T>;
+				return std::bit_cast<word_type>(value) == static_cast<word_type>(static_cast<word_type>(~word_type{ 0 }) / 0xFF * static_cast<unsigned char>(pattern));
+			}
+			else {
+				if constexpr (bit_castable<T>) {
+					if (std::is_constant_evaluated()) {
+						auto bytes = to_byte_array(value);
+						return all_bytes_equal_scalar(bytes.data(), bytes.size(), pattern);
+					}
+				}
+				return all_bytes_equal(reinterpret_cast<const std::byte*>(&value), sizeof(T), pattern);
+			}
+		}
+
+		// Returns the 64-bit word at <offset> of <size> bytes starting at <ptr> with the bits searched for set to 1: the bits set to 1
+		// themselves, or the bits set to 0 if <Zero>. A word that runs past the end only has the bits inside the range
+		template<bool Zero>
+		constexpr std::uint64_t search_word(const std::byte* ptr, size_t size, size_t offset) noexcept {
+			if (offset + sizeof(std::uint64_t) <= size)
+				return Zero ? ~load_word(ptr + offset) : load_word(ptr + offset);
+
+			std::array<std::byte, sizeof(std::uint64_t)> bytes{};
+			std::copy(ptr + offset, ptr + size, bytes.begin());
+			std::uint64_t word{ Zero ? ~load_word(bytes.data()) : load_word(bytes.data()) };
+			return word & ~(~std::uint64_t{ 0 } << ((size - offset) * BITS_PER_BYTE));
+		}
+
+		// Returns the index of the first bit at or after <from> of <size> bytes starting at <ptr> that is set to 1 (0 if <Zero>), or npos
+		template<bool Zero>
+		constexpr size_t find_next_scalar(const std::byte* ptr, size_t size, size_t from) noexcept {
+			if (from >= size * BITS_PER_BYTE)
+				return npos;
+
+			size_t offset{ from / 64 * sizeof(std::uint64_t) };
+			std::uint64_t word{ search_word<Zero>(ptr, size, offset) & (~std::uint64_t{ 0 } << (from % 64)) };
+
+			while (word == 0) {
+				offset += sizeof(std::uint64_t);
+				if (offset >= size)
+					return npos;
+				word = search_word<Zero>(ptr, size, offset);
+			}
+
+			return offset * BITS_PER_BYTE + static_cast<size_t>(std::countr_zero(word));
+		}
+
+		// Returns the index of the last bit before <before> of <size> bytes starting at <ptr> that is set to 1 (0 if <Zero>), or npos
+		template<bool Zero>
+		constexpr size_t find_prev_scalar(const std::byte* ptr, size_t size, size_t before) noexcept {
+			if (before == 0)
+				return npos;
+
+			size_t last{ before - 1 };
+			size_t offset{ last / 64 * sizeof(std::uint64_t) };
+			std::uint64_t word{ search_word<Zero>(ptr, size, offset) & (~std::uint64_t{ 0 } >> (63 - last % 64)) };
+
+			while (word == 0) {
+				if (offset == 0)
+					return npos;
+				offset -= sizeof(std::uint64_t);
+				word = search_word<Zero>(ptr, size, offset);
+			}
+
+			return offset * BITS_PER_BYTE + 63 - static_cast<size_t>(std::countl_zero(word));
+		}
+
+#ifdef IMD_X86_SIMD
+		// Returns true if the 32 bytes of <block> have no bit set to 1 (0 if <Zero>)
+		template<bool Zero>
+		__attribute__((target("avx2")))
+		inline bool nothing_to_find_avx2(__m256i block) noexcept {
+			if constexpr (Zero)
+				return _mm256_testc_si256(block, _mm256_set1_epi8(-1));
+			else
+				return _mm256_testz_si256(block, block);
+		}
+
+		// Same as find_next_scalar: after the word with <from>, whole 32-byte blocks with nothing to find are skipped with VPTEST
+		template<bool Zero>
+		__attribute__((target("avx2,bmi,lzcnt")))
+		size_t find_next_avx2(const std::byte* ptr, size_t size, size_t from) noexcept {
+			if (from >= size * BITS_PER_BYTE)
+				return npos;
+
+			size_t offset{ from / 64 * sizeof(std::uint64_t) };
+			if (std::uint64_t word = search_word<Zero>(ptr, size, offset) & (~std::uint64_t{ 0 } << (from % 64)); word != 0)
+				return offset * BITS_PER_BYTE + static_cast<size_t>(std::countr_zero(word));
+
+			offset += sizeof(std::uint64_t);
+			for (; offset + sizeof(__m256i) <= size; offset += sizeof(__m256i))
+				if (!nothing_to_find_avx2<Zero>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + offset))))
+					break;
+
+			return find_next_scalar<Zero>(ptr, size, offset * BITS_PER_BYTE);
+		}
+
+		// Same as find_prev_scalar: below the word with the bit before <before>, whole 32-byte blocks with nothing to find are skipped with VPTEST
+		template<bool Zero>
+		__attribute__((target("avx2,bmi,lzcnt")))
+		size_t find_prev_avx2(const std::byte* ptr, size_t size, size_t before) noexcept {
+			if (before == 0)
+				return npos;
+
+			size_t last{ before - 1 };
+			size_t offset{ last / 64 * sizeof(std::uint64_t) };
+			if (std::uint64_t word = search_word<Zero>(ptr, size, offset) & (~std::uint64_t{ 0 } >> (63 - last % 64)); word != 0)
+				return offset * BITS_PER_BYTE + 63 - static_cast<size_t>(std::countl_zero(word));
+
+			for (; offset >= sizeof(__m256i); offset -= sizeof(__m256i))
+				if (!nothing_to_find_avx2<Zero>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + offset - sizeof(__m256i)))))
+					break;
+
+			return find_prev_scalar<Zero>(ptr, size, offset * BITS_PER_BYTE);
+		}
+#endif
+
+		// Returns the index of the first bit at or after <from> of <size> bytes starting at <ptr> that is set to 1 (0 if <Zero>), or npos
+		template<bool Zero>
+		size_t find_next(const std::byte* ptr, size_t size, size_t from) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<size_t(const std::byte*, size_t, size_t)>(
+				cpu::implementation(cpu::kernel::find_bit), { find_next_scalar<Zero>, nullptr, nullptr, find_next_avx2<Zero>, nullptr });
+			if (from / BITS_PER_BYTE + SIMD_THRESHOLD <= size)
+				return bulk(ptr, size, from);
+#endif
+			return find_next_scalar<Zero>(ptr, size, from);
+		}
+
+		// Returns the index of the last bit before <before> of <size> bytes starting at <ptr> that is set to 1 (0 if <Zero>), or npos
+		template<bool Zero>
+		size_t find_prev(const std::byte* ptr, size_t size, size_t before) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<size_t(const std::byte*, size_t, size_t)>(
+				cpu::implementation(cpu::kernel::find_bit), { find_prev_scalar<Zero>, nullptr, nullptr, find_prev_avx2<Zero>, nullptr });
+			if (before / BITS_PER_BYTE >= SIMD_THRESHOLD)
+				return bulk(ptr, size, before);
+#endif
+			return find_prev_scalar<Zero>(ptr, size, before);
+		}
+
+		// Returns the index of the first bit at or after <from> of <value> that is set to 1 (0 if <Zero>), or npos
+		template<bool Zero, typename T>
+		constexpr size_t find_next(const T& value, size_t from) noexcept {
+			if constexpr (natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t)) {
+				if (from >= sizeof(T) * BITS_PER_BYTE)
+					return npos;
+				using word_type = native_word_t<T>;
+				auto word = static_cast<std::uint64_t>(Zero ? static_cast<word_type>(~std::bit_cast<word_type>(value)) : std::bit_cast<word_type>(value)) >> from;
+				return word == 0 ? npos : from + static_cast<size_t>(std::countr_zero(word));
+			}
+			else {
+				if constexpr (bit_castable<T>) {
+					if (std::is_constant_evaluated()) {
+						auto bytes = to_byte_array(value);
+						return find_next_scalar<Zero>(bytes.data(), bytes.size(), from);
+					}
+				}
+				return find_next<Zero>(reinterpret_cast<const std::byte*>(&value), sizeof(T), from);
+			}
+		}
+
+		// Returns the index of the last bit of <value> that is set to 1 (0 if <Zero>), or npos
+		template<bool Zero, typename T>
+		constexpr size_t find_last(const T& value) noexcept {
+			if constexpr (natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t)) {
+				using word_type = native_word_t<T>;
+				auto word = static_cast<std::uint64_t>(Zero ? static_cast<word_type>(~std::bit_cast<word_type>(value)) : std::bit_cast<word_type>(value));
+				return word == 0 ? npos : 63 - static_cast<size_t>(std::countl_zero(word));
+			}
+			else {
+				if constexpr (bit_castable<T>) {
+					if (std::is_constant_evaluated()) {
+						auto bytes = to_byte_array(value);
+						return find_prev_scalar<Zero>(bytes.data(), bytes.size(), bytes.size() * BITS_PER_BYTE);
+					}
+				}
+				return find_prev<Zero>(reinterpret_cast<const std::byte*>(&value), sizeof(T), sizeof(T) * BITS_PER_BYTE);
+			}
+		}
+
+		// Calls <f> with the index of every bit set to 1 of <size> bytes starting at <ptr>, from the lowest, clearing each bit
+		// with word & (word - 1) once it is visited. If <f> returns bool, returning false stops the iteration
+		template<typename F>
+		constexpr void for_each_set_bit(const std::byte* ptr, size_t size, F& f) {
+			for (size_t offset{ 0 }; offset < size; offset += sizeof(std::uint64_t)) {
+				std::uint64_t word{ search_word<false>(ptr, size, offset) };
+
+				for (; word != 0; word &= word - 1) {
+					size_t index{ offset * BITS_PER_BYTE + static_cast<size_t>(std::countr_zero(word)) };
+					if constexpr (std::is_same_v<std::invoke_result_t<F&, size_t>, bool>) {
+						if (!f(index))
+							return;
+					}
+					else
+						f(index);
+				}
+			}
+		}
+
+		// Writes <base> plus the index of every bit set to 1 of <size> bytes starting at <ptr> to <out> and returns how many it wrote
+		constexpr size_t decode_set_bits_scalar(const std::byte* ptr, size_t size, std::uint32_t* out, std::uint32_t base) noexcept {
+			std::uint32_t* first{ out };
+
+			for (size_t offset{ 0 }; offset < size; offset += sizeof(std::uint64_t)) {
+				std::uint64_t word{ search_word<false>(ptr, size, offset) };
+				auto word_base = static_cast<std::uint32_t>(base + offset * BITS_PER_BYTE);
+
+				for (; word != 0; word &= word - 1)
+					*out++ = word_base + static_cast<std::uint32_t>(std::countr_zero(word));
+			}
+
+			return static_cast<size_t>(out - first);
+		}
+
+#ifdef IMD_X86_SIMD
+		// Same as decode_set_bits_scalar, compiled for TZCNT and BLSR
+		__attribute__((target("bmi,bmi2")))
+		inline size_t decode_set_bits_bmi2(const std::byte* ptr, size_t size, std::uint32_t* out, std::uint32_t base) noexcept {
+			return decode_set_bits_scalar(ptr, size, out, base);
+		}
+
+		// Widens the first <count> (at most 16) byte indices of <bytes> to 32 bits, adds <base> and stores them to <out>
+		__attribute__((target("avx512f")))
+		inline void store_indices_avx512(std::uint32_t* out, __m128i bytes, __m512i base, unsigned count) noexcept {
+			auto mask = static_cast<__mmask16>((1u << count) - 1);
+			_mm512_mask_storeu_epi32(out, mask, _mm512_add_epi32(_mm512_maskz_cvtepu8_epi32(mask, bytes), base));
+		}
+
+		// Same as decode_set_bits_scalar for 64 bytes per iteration. One VPCOMPRESSB per word packs the positions of its bits
+		// set to 1 out of a vector of 0 to 63, which are then widened and stored with masked stores that write exactly as many
+		// indices as there are bits set. There are no branches per bit or per word, only blocks of 512 zero bits are skipped
+		__attribute__((target("avx512f,avx512bw,avx512vbmi2,popcnt")))
+		inline size_t decode_set_bits_avx512(const std::byte* ptr, size_t size, std::uint32_t* out, std::uint32_t base) noexcept {
+			static constexpr auto POSITIONS = [] {
+				std::array<unsigned char, 64> result{};
+				for (size_t i{ 0 }; i < result.size(); ++i)
+					result[i] = static_cast<unsigned char>(i);
+				return result;
+			}();
+			const __m512i positions = _mm512_loadu_si512(POSITIONS.data());
+			std::uint32_t* first{ out };
+			size_t offset{ 0 };
+
+			for (; offset + sizeof(__m512i) <= size; offset += sizeof(__m512i)) {
+				__m512i block = _mm512_loadu_si512(ptr + offset);
+				if (_mm512_test_epi64_mask(block, block) == 0)
+					continue;
+
+				for (size_t word_offset{ offset }; word_offset < offset + sizeof(__m512i); word_offset += sizeof(std::uint64_t)) {
+					std::uint64_t word{ load_word(ptr + word_offset) };
+					auto count = static_cast<unsigned>(std::popcount(word));
+					__m512i bytes = _mm512_maskz_compress_epi8(word, positions);
+					__m512i word_base = _mm512_set1_epi32(static_cast<int>(base + word_offset * BITS_PER_BYTE));
+
+					store_indices_avx512(out, _mm512_maskz_extracti32x4_epi32(0xF, bytes, 0), word_base, std::min(count, 16u));
+					if (count > 16) {
+						store_indices_avx512(out + 16, _mm512_maskz_extracti32x4_epi32(0xF, bytes, 1), word_base, std::min(count - 16, 16u));
+						if (count > 32) {
+							store_indices_avx512(out + 32, _mm512_maskz_extracti32x4_epi32(0xF, bytes, 2), word_base, std::min(count - 32, 16u));
+							if (count > 48)
+								store_indices_avx512(out + 48, _mm512_maskz_extracti32x4_epi32(0xF, bytes, 3), word_base, count - 48);
+						}
+					}
+					out += count;
+				}
+			}
+
+			out += decode_set_bits_scalar(ptr + offset, size - offset, out, static_cast<std::uint32_t>(base + offset * BITS_PER_BYTE));
+			return static_cast<size_t>(out - first);
+		}
+#endif
+
+		// Writes the index of every bit set to 1 of <size> bytes starting at <ptr> to <out> and returns how many it wrote
+		inline size_t decode_set_bits(const std::byte* ptr, size_t size, std::uint32_t* out) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto kernel = select_kernel<size_t(const std::byte*, size_t, std::uint32_t*, std::uint32_t)>(
+				cpu::implementation(cpu::kernel::decode_bits), { decode_set_bits_scalar, nullptr, decode_set_bits_bmi2, nullptr, decode_set_bits_avx512 });
+			return kernel(ptr, size, out, 0);
+#else
+			return decode_set_bits_scalar(ptr, size, out, 0);
+#endif
+		}
+
+		// Throws if the bits of <size> bytes cannot all be indexed with 32 bits
+		inline void validate_decode_size(size_t size) {
+			if (size > (size_t{ 1 } << 29))
+				raise<std::runtime_error>("Range has too many bits for 32-bit indices");
+		}
+
+		// PEXT of every 4-bit value by every 4-bit mask, indexed by mask << 4 | value, with the number of bits set in the mask in the high nibble
+		inline constexpr auto NIBBLE_EXTRACT = [] {
+			std::array<std::uint8_t, 256> table{};
+			for (unsigned mask{ 0 }; mask < 16; ++mask)
+				for (unsigned value{ 0 }; value < 16; ++value) {
+					unsigned result{ 0 }, count{ 0 };
+					for (unsigned bit{ 0 }; bit < 4; ++bit)
+						if (mask & (1u << bit))
+							result |= ((value >> bit) & 1u) << count++;
+					table[mask << 4 | value] = static_cast<std::uint8_t>(count << 4 | result);
+				}
+			return table;
+		}();
+
+		// PDEP of every 4-bit value into every 4-bit mask, indexed by mask << 4 | value, with the number of bits set in the mask in the high nibble
+		inline constexpr auto NIBBLE_DEPOSIT = [] {
+			std::array<std::uint8_t, 256> table{};
+			for (unsigned mask{ 0 }; mask < 16; ++mask)
+				for (unsigned value{ 0 }; value < 16; ++value) {
+					unsigned result{ 0 }, count{ 0 };
+					for (unsigned bit{ 0 }; bit < 4; ++bit)
+						if (mask & (1u << bit))
+							result |= ((value >> count++) & 1u) << bit;
+					table[mask << 4 | value] = static_cast<std::uint8_t>(count << 4 | result);
+				}
+			return table;
+		}();
+
+		// Returns a word with the lowest bit of every nibble of <mask> that is not zero set to 1
+		constexpr std::uint64_t nonzero_nibbles(std::uint64_t mask) noexcept {
+			std::uint64_t nibbles{ mask | mask >> 1 };
+			return (nibbles | nibbles >> 2) & 0x1111111111111111;
+		}
+
+		// Gathers the bits of <word> selected by <mask> into the lowest bits of the result (PEXT) through NIBBLE_EXTRACT, visiting
+		// only the nibbles of the mask that are not zero. The lookups are independent of each other, only the running bit count
+		// is carried from one to the next
+		constexpr std::uint64_t extract_word_scalar(std::uint64_t word, std::uint64_t mask) noexcept {
+			std::uint64_t result{ 0 };
+			unsigned count{ 0 };
+
+			for (std::uint64_t nibbles{ nonzero_nibbles(mask) }; nibbles != 0; nibbles &= nibbles - 1) {
+				auto shift = static_cast<unsigned>(std::countr_zero(nibbles));
+				std::uint8_t entry{ NIBBLE_EXTRACT[(mask >> shift & 0xF) << 4 | (word >> shift & 0xF)] };
+				result |= std::uint64_t{ entry & 0xFu } << count;
+				count += entry >> 4;
+			}
+
+			return result;
+		}
+
+		// Scatters the lowest bits of <word> to the bits set in <mask> and clears the others (PDEP) through NIBBLE_DEPOSIT, visiting
+		// only the nibbles of the mask that are not zero
+		constexpr std::uint64_t deposit_word_scalar(std::uint64_t word, std::uint64_t mask) noexcept {
+			std::uint64_t result{ 0 };
+			unsigned count{ 0 };
+
+			for (std::uint64_t nibbles{ nonzero_nibbles(mask) }; nibbles != 0; nibbles &= nibbles - 1) {
+				auto shift = static_cast<unsigned>(std::countr_zero(nibbles));
+				std::uint8_t entry{ NIBBLE_DEPOSIT[(mask >> shift & 0xF) << 4 | (word >> count & 0xF)] };
+				result |= std::uint64_t{ entry & 0xFu } << shift;
+				count += entry >> 4;
+			}
+
+			return result;
+		}
+
+		// Stores as many of the lowest bytes of <word> as fit before the end of <size> bytes starting at <ptr> at <offset>
+		constexpr void store_tail_word(std::byte* ptr, size_t size, size_t offset, std::uint64_t word) noexcept {
+			if (offset + sizeof(std::uint64_t) <= size) {
+				store_word(ptr + offset, word);
+				return;
+			}
+
+			for (; offset < size; ++offset, word >>= BITS_PER_BYTE)
+				ptr[offset] = static_cast<std::byte>(word);
+		}
+
+		// Appends runs of up to 64 bits to <size> bytes starting at <ptr>, storing one word each time 64 bits have been collected
+		struct bit_sink {
+			std::byte* ptr;
+			size_t size;
+			size_t offset{ 0 };
+			std::uint64_t pending{ 0 };
+			unsigned filled{ 0 };
+
+			// Appends the lowest <count> bits of <bits>, whose other bits must be zero
+			constexpr void append(std::uint64_t bits, unsigned count) noexcept {
+				pending |= bits << filled;
+				filled += count;
+				if (filled >= 64) {
+					store_word(ptr + offset, pending);
+					offset += sizeof(std::uint64_t);
+					filled -= 64;
+					pending = filled == 0 ? 0 : bits >> (count - filled);
+				}
+			}
+
+			// Stores the bits collected so far and clears the rest of the bytes
+			constexpr void finish() noexcept {
+				for (; offset < size; ++offset, pending >>= BITS_PER_BYTE)
+					ptr[offset] = static_cast<std::byte>(pending);
+			}
+		};
+
+		// Takes runs of up to 64 bits from <size> bytes starting at <ptr>, loading one word each time the previous one is used up
+		struct bit_source {
+			const std::byte* ptr;
+			size_t size;
+			size_t offset{ 0 };
+			std::uint64_t current{ 0 };
+			unsigned available{ 0 };
+
+			// Returns the next <count> bits in the lowest bits of the result
+			constexpr std::uint64_t take(unsigned count) noexcept {
+				if (count <= available) {
+					std::uint64_t bits{ current & ~(~std::uint64_t{ 0 } << count) };
+					current >>= count;
+					available -= count;
+					return bits;
+				}
+
+				std::uint64_t next{ search_word<false>(ptr, size, offset) };
+				offset += sizeof(std::uint64_t);
+				std::uint64_t bits{ current | next << available };
+				unsigned used{ count - available };
+				current = used == 64 ? 0 : next >> used;
+				available = 64 - used;
+				return count == 64 ? bits : bits & ~(~std::uint64_t{ 0 } << count);
+			}
+		};
+
+		// Gathers the bits of <size> bytes starting at <value> selected by the bits set in <size> bytes starting at <mask> into
+		// <out_size> bytes starting at <out>, which must have room for all of them, and clears the rest of <out>
+		constexpr void extract_bits_scalar(const std::byte* value, const std::byte* mask, size_t size, std::byte* out, size_t out_size) noexcept {
+			bit_sink sink{ out, out_size };
+			for (size_t offset{ 0 }; offset < size; offset += sizeof(std::uint64_t)) {
+				std::uint64_t mask_word{ search_word<false>(mask, size, offset) };
+				if (mask_word != 0)
+					sink.append(extract_word_scalar(search_word<false>(value, size, offset), mask_word), static_cast<unsigned>(std::popcount(mask_word)));
+			}
+			sink.finish();
+		}
+
+		// Scatters the lowest bits of <source_size> bytes starting at <source> to the bits set in <size> bytes starting at <mask>
+		// of <size> bytes starting at <destination>, leaving its other bits unchanged. <source> must have enough bits
+		constexpr void deposit_bits_scalar(const std::byte* source, size_t source_size, const std::byte* mask, std::byte* destination, size_t size) noexcept {
+			bit_source bits{ source, source_size };
+			for (size_t offset{ 0 }; offset < size; offset += sizeof(std::uint64_t)) {
+				std::uint64_t mask_word{ search_word<false>(mask, size, offset) };
+				if (mask_word == 0)
+					continue;
+
+				std::uint64_t deposited{ deposit_word_scalar(bits.take(static_cast<unsigned>(std::popcount(mask_word))), mask_word) };
+				store_tail_word(destination, size, offset, (search_word<false>(destination, size, offset) & ~mask_word) | deposited);
+			}
+		}
+
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+		// Same as extract_word_scalar with PEXT
+		__attribute__((target("bmi2")))
+		inline std::uint64_t extract_word_bmi2(std::uint64_t word, std::uint64_t mask) noexcept {
+			return _pext_u64(word, mask);
+		}
+
+		// Same as deposit_word_scalar with PDEP
+		__attribute__((target("bmi2")))
+		inline std::uint64_t deposit_word_bmi2(std::uint64_t word, std::uint64_t mask) noexcept {
+			return _pdep_u64(word, mask);
+		}
+
+		// Same as extract_bits_scalar with PEXT
+		__attribute__((target("bmi2,popcnt")))
+		inline void extract_bits_bmi2(const std::byte* value, const std::byte* mask, size_t size, std::byte* out, size_t out_size) noexcept {
+			bit_sink sink{ out, out_size };
+			for (size_t offset{ 0 }; offset < size; offset += sizeof(std::uint64_t)) {
+				std::uint64_t mask_word{ search_word<false>(mask, size, offset) };
+				if (mask_word != 0)
+					sink.append(_pext_u64(search_word<false>(value, size, offset), mask_word), static_cast<unsigned>(std::popcount(mask_word)));
+			}
+			sink.finish();
+		}
+
+		// Same as deposit_bits_scalar with PDEP
+		__attribute__((target("bmi2,popcnt")))
+		inline void deposit_bits_bmi2(const std::byte* source, size_t source_size, const std::byte* mask, std::byte* destination, size_t size) noexcept {
+			bit_source bits{ source, source_size };
+			for (size_t offset{ 0 }; offset < size; offset += sizeof(std::uint64_t)) {
+				std::uint64_t mask_word{ search_word<false>(mask, size, offset) };
+				if (mask_word == 0)
+					continue;
+
+				std::uint64_t deposited{ _pdep_u64(bits.take(static_cast<unsigned>(std::popcount(mask_word))), mask_word) };
+				store_tail_word(destination, size, offset, (search_word<false>(destination, size, offset) & ~mask_word) | deposited);
+			}
+		}
+#endif
+
+		// Gathers the bits of <word> selected by <mask> (PEXT), with the instruction when the CPU runs it in hardware
+		inline std::uint64_t extract_word(std::uint64_t word, std::uint64_t mask) noexcept {
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+			static const auto kernel = select_kernel<std::uint64_t(std::uint64_t, std::uint64_t)>(
+				cpu::implementation(cpu::kernel::extract_deposit), { extract_word_scalar, nullptr, extract_word_bmi2, nullptr, nullptr });
+			return kernel(word, mask);
+#else
+			return extract_word_scalar(word, mask);
+#endif
+		}
+
+		// Scatters the lowest bits of <word> to the bits set in <mask> (PDEP), with the instruction when the CPU runs it in hardware
+		inline std::uint64_t deposit_word(std::uint64_t word, std::uint64_t mask) noexcept {
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+			static const auto kernel = select_kernel<std::uint64_t(std::uint64_t, std::uint64_t)>(
+				cpu::implementation(cpu::kernel::extract_deposit), { deposit_word_scalar, nullptr, deposit_word_bmi2, nullptr, nullptr });
+			return kernel(word, mask);
+#else
+			return deposit_word_scalar(word, mask);
+#endif
+		}
+
+		// Gathers the bits of <value> selected by <mask> into <out>, which must have room for all of them, and clears the rest of <out>.
+		// Returns the number of bits gathered
+		inline size_t extract_bits(std::span<const std::byte> value, std::span<const std::byte> mask, std::span<std::byte> out) {
+			if (value.size() != mask.size())
+				raise<std::runtime_error>("Ranges have different sizes");
+			size_t count{ popcount(mask.data(), mask.size()) };
+			if (count > out.size() * BITS_PER_BYTE)
+				raise<std::runtime_error>("Result is too small for the extracted bits");
+
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+			static const auto kernel = select_kernel<void(const std::byte*, const std::byte*, size_t, std::byte*, size_t)>(
+				cpu::implementation(cpu::kernel::extract_deposit), { extract_bits_scalar, nullptr, extract_bits_bmi2, nullptr, nullptr });
+			kernel(value.data(), mask.data(), value.size(), out.data(), out.size());
+#else
+			extract_bits_scalar(value.data(), mask.data(), value.size(), out.data(), out.size());
+#endif
+			return count;
+		}
+
+		// Scatters the lowest bits of <source> to the bits of <destination> selected by <mask>, leaving its other bits unchanged.
+		// Returns the number of bits scattered
+		inline size_t deposit_bits(std::span<const std::byte> source, std::span<const std::byte> mask, std::span<std::byte> destination) {
+			if (destination.size() != mask.size())
+				raise<std::runtime_error>("Ranges have different sizes");
+			size_t count{ popcount(mask.data(), mask.size()) };
+			if (count > source.size() * BITS_PER_BYTE)
+				raise<std::runtime_error>("Source is too small for the deposited bits");
+
+#if defined(IMD_X86_SIMD) && defined(__x86_64__)
+			static const auto kernel = select_kernel<void(const std::byte*, size_t, const std::byte*, std::byte*, size_t)>(
+				cpu::implementation(cpu::kernel::extract_deposit), { deposit_bits_scalar, nullptr, deposit_bits_bmi2, nullptr, nullptr });
+			kernel(source.data(), source.size(), mask.data(), destination.data(), destination.size());
+#else
+			deposit_bits_scalar(source.data(), source.size(), mask.data(), destination.data(), destination.size());
+#endif
+			return count;
+		}
+
+		// Throws unless the bits [from, to) are within <size> bytes
+		constexpr void validate_bit_range(size_t size, size_t from, size_t to) {
+			if (from > to || to > size * BITS_PER_BYTE)
+				raise<std::runtime_error>("Bit range is outside the size of the value");
+		}
+
+		// Throws unless the <width> bits starting at <offset> are within <size> bytes and fit in a 64-bit word
+		constexpr void validate_bit_field(size_t size, size_t offset, size_t width) {
+			if (width > 64)
+				raise<std::runtime_error>("Bit field is wider than 64 bits");
+			validate_bit_range(size, offset, offset + width);
+		}
+
+		// Returns the mask of the bits [from, to) of a 64-bit word
+		constexpr std::uint64_t range_mask(size_t from, size_t to) noexcept {
+			if (from == to)
+				return 0;
+			return (to - from == 64 ? ~std::uint64_t{ 0 } : ~(~std::uint64_t{ 0 } << (to - from))) << from;
+		}
+
+		// The 64-bit words covered by the bits [from, to), as byte offsets: the ones covered wholly, [begin, end), and the masks of the
+		// bits in the range of the partly covered word at <head> before them and of the partly covered word at <end> after them.
+		// A mask of 0 means the word is not covered at all
+		struct bit_range_words {
+			size_t head;
+			std::uint64_t head_mask;
+			size_t begin;
+			size_t end;
+			std::uint64_t tail_mask;
+		};
+
+		// Splits the bits [from, to) into the 64-bit words they cover
+		constexpr bit_range_words split_bit_range(size_t from, size_t to) noexcept {
+			size_t first_word{ from / 64 };
+			size_t last_word{ to / 64 };
+
+			if (from % 64 != 0 && first_word == last_word)
+				return { first_word * sizeof(std::uint64_t), range_mask(from % 64, to % 64), (first_word + 1) * sizeof(std::uint64_t), (first_word + 1) * sizeof(std::uint64_t), 0 };
+
+			return { first_word * sizeof(std::uint64_t), range_mask(from % 64, from % 64 == 0 ? 0 : 64), (from + 63) / 64 * sizeof(std::uint64_t),
+				last_word * sizeof(std::uint64_t), range_mask(0, to % 64) };
+		}
+
+		// Counts the bits set to 1 among the bits [from, to) of <size> bytes starting at <ptr>, with the SIMD kernels over the whole words
+		constexpr size_t popcount_range(const std::byte* ptr, size_t size, size_t from, size_t to) noexcept {
+			bit_range_words range{ split_bit_range(from, to) };
+			size_t count{ 0 };
+
+			if (range.head_mask != 0 && range.head < size)
+				count += std::popcount(search_word<false>(ptr, size, range.head) & range.head_mask);
+			count += std::is_constant_evaluated() ? popcount_scalar(ptr + range.begin, range.end - range.begin) : popcount(ptr + range.begin, range.end - range.begin);
+			if (range.tail_mask != 0 && range.end < size)
+				count += std::popcount(search_word<false>(ptr, size, range.end) & range.tail_mask);
+
+			return count;
+		}
+
+		// Returns true if all the bits [from, to) of <size> bytes starting at <ptr> are equal to the bits of <pattern>, 0x00 or 0xFF
+		constexpr bool all_bits_equal_range(const std::byte* ptr, size_t size, size_t from, size_t to, std::byte pattern) noexcept {
+			bit_range_words range{ split_bit_range(from, to) };
+			std::uint64_t expected{ pattern == std::byte{ 0 } ? 0 : ~std::uint64_t{ 0 } };
+
+			if (range.head_mask != 0 && range.head < size && ((search_word<false>(ptr, size, range.head) ^ expected) & range.head_mask) != 0)
+				return false;
+			if (range.tail_mask != 0 && range.end < size && ((search_word<false>(ptr, size, range.end) ^ expected) & range.tail_mask) != 0)
+				return false;
+			return std::is_constant_evaluated() ? all_bytes_equal_scalar(ptr + range.begin, range.end - range.begin, pattern)
+				: all_bytes_equal(ptr + range.begin, range.end - range.begin, pattern);
+		}
+
+		// Sets all the bits [from, to) of <size> bytes starting at <ptr> to <new_bit>, with a memset over the whole words
+		constexpr void fill_range(std::byte* ptr, size_t size, size_t from, size_t to, bool new_bit) noexcept {
+			bit_range_words range{ split_bit_range(from, to) };
+
+			if (range.head_mask != 0 && range.head < size) {
+				std::uint64_t word{ search_word<false>(ptr, size, range.head) };
+				store_tail_word(ptr, size, range.head, new_bit ? word | range.head_mask : word & ~range.head_mask);
+			}
+			std::fill_n(ptr + range.begin, range.end - range.begin, new_bit ? std::byte{ 0xFF } : std::byte{ 0x00 });
+			if (range.tail_mask != 0 && range.end < size) {
+				std::uint64_t word{ search_word<false>(ptr, size, range.end) };
+				store_tail_word(ptr, size, range.end, new_bit ? word | range.tail_mask : word & ~range.tail_mask);
+			}
+		}
+
+		// Returns the <width> bits starting at <offset> of <size> bytes starting at <ptr> in the lowest bits of a word. They are read
+		// with one 64-bit load, and a ninth byte when they straddle it
+		constexpr std::uint64_t get_bit_field(const std::byte* ptr, size_t size, size_t offset, size_t width) noexcept {
+			if (width == 0)
+				return 0;
+
+			size_t byte_offset{ offset / BITS_PER_BYTE };
+			auto shift = static_cast<unsigned>(offset % BITS_PER_BYTE);
+			std::uint64_t word{ search_word<false>(ptr, size, byte_offset) >> shift };
+			if (shift + width > 64 && byte_offset + sizeof(std::uint64_t) < size)
+				word |= static_cast<std::uint64_t>(ptr[byte_offset + sizeof(std::uint64_t)]) << (64 - shift);
+			return word & range_mask(0, width);
+		}
+
+		// Sets the <width> bits starting at <offset> of <size> bytes starting at <ptr> to the lowest bits of <bits>, with one 64-bit
+		// read-modify-write, and a ninth byte when they straddle it
+		constexpr void set_bit_field(std::byte* ptr, size_t size, size_t offset, size_t width, std::uint64_t bits) noexcept {
+			if (width == 0)
+				return;
+
+			size_t byte_offset{ offset / BITS_PER_BYTE };
+			auto shift = static_cast<unsigned>(offset % BITS_PER_BYTE);
+			std::uint64_t mask{ range_mask(0, width) };
+			bits &= mask;
+
+			std::uint64_t word{ search_word<false>(ptr, size, byte_offset) };
+			store_tail_word(ptr, size, byte_offset, (word & ~(mask << shift)) | bits << shift);
+			if (shift + width > 64 && byte_offset + sizeof(std::uint64_t) < size) {
+				std::byte high_mask{ static_cast<std::uint8_t>(mask >> (64 - shift)) };
+				std::byte& last = ptr[byte_offset + sizeof(std::uint64_t)];
+				last = (last & ~high_mask) | std::byte{ static_cast<std::uint8_t>(bits >> (64 - shift)) };
+			}
+		}
+
+		// Compares the bytes of <first> and <second> lexicographically
+		inline int compare(std::span<const std::byte> first, std::span<const std::byte> second) noexcept {
+			size_t common = std::min(first.size(), second.size());
+			if (common != 0)
+				if (int result = memcmp(first.data(), second.data(), common); result != 0)
+					return result;
+
+			return (first.size() > second.size()) - (first.size() < second.size());
+		}
+
+		// Swaps the bytes of <first> and <second>
+		inline void swap(std::span<std::byte> first, std::span<std::byte> second) {
+			if (first.size() != second.size())
+				raise<std::runtime_error>("Ranges have different sizes");
+
+			std::swap_ranges(first.begin(), first.end(), second.begin());
+		}
+
+		// Changes the byte with the specified <index> of the bytes starting at <ptr>, which must be inside them
+		inline void modify_byte_unchecked(std::byte* ptr, size_t index, std::byte new_byte) noexcept {
+			ptr[index] = new_byte;
+		}
+
+		// Changes the bit with the specified <index> of the bytes starting at <ptr>, which must be inside them, to <new_bit>
+		// with a branchless read-modify-write of its byte
+		inline void modify_bit_unchecked(std::byte* ptr, size_t index, bool new_bit) noexcept {
+			auto shift = static_cast<unsigned>(index % BITS_PER_BYTE);
+			auto byte = static_cast<unsigned>(ptr[index / BITS_PER_BYTE]);
+			ptr[index / BITS_PER_BYTE] = static_cast<std::byte>((byte & ~(1u << shift)) | unsigned{ new_bit } << shift);
+		}
+
+		// Changes the byte with the specified <index> of <size> bytes starting at <ptr>
+		inline void modify_byte(std::byte* ptr, size_t size, size_t index, std::byte new_byte) {
+			check_index(index, size, "Byte index is outside the size of the value");
+			modify_byte_unchecked(ptr, index, new_byte);
+		}
+
+		// Changes the bit with the specified <index> of <size> bytes starting at <ptr> to <new_bit>
+		inline void modify_bit(std::byte* ptr, size_t size, size_t index, bool new_bit) {
+			check_index(index, size * BITS_PER_BYTE, "Bit index is outside the size of the value");
+			modify_bit_unchecked(ptr, index, new_bit);
+		}
+
+		// Copies the first sizeof(T) bytes from <first>, which must have at least as many, into a value of type <T>. Contiguous
+		// bytes are copied with one memcpy, which compiles to a single unaligned load for word-sized types
+		template<typename T, typename InputIt>
+		T restore_value_unchecked(InputIt first) {
+			T value;
+			auto ptr = reinterpret_cast<std::byte*>(&value);
+			if constexpr (std::contiguous_iterator<InputIt> && sizeof(std::iter_value_t<InputIt>) == 1)
+				std::memcpy(ptr, std::to_address(first), sizeof(T));
+			else
+				for (size_t i{ 0 }; i < sizeof(T); ++i, ++first)
+					ptr[i] = static_cast<std::byte>(*first);
+
+			return value;
+		}
+
+		// Returns true if [first, last) has at least sizeof(T) bytes
+		template<typename T, typename InputIt>
+		bool enough_bytes(InputIt first, InputIt last) {
+			return std::distance(first, last) >= static_cast<std::ptrdiff_t>(sizeof(T));
+		}
+
+		// Throws <message> if any index of <edits> is not below <limit>. The comparisons are folded together without branches, so
+		// checking a valid patch costs one pass over its indices and a single test at the end
+		template<typename Edit>
+		void validate_edits(std::span<const Edit> edits, size_t limit, const char* message) {
+			bool outside{ false };
+			for (const Edit& edit : edits)
+				outside |= edit.index >= limit;
+
+			if (outside)
+				raise<std::runtime_error>(message);
+		}
+
+		// Applies <edits>, whose indices must be valid, to the bytes starting at <ptr> in order. A byte edit is already a single store,
+		// so all that is saved over modify_byte is the check of each index
+		inline void apply_byte_edits(std::byte* ptr, std::span<const byte_edit> edits) noexcept {
+			for (const byte_edit& edit : edits)
+				modify_byte_unchecked(ptr, edit.index, edit.value);
+		}
+
+		// Applies <edits>, whose indices must be valid, to <size> bytes starting at <ptr> in order. Where 64 edits in a row set the
+		// bits of one 64-bit word in ascending order, as in a dense sorted patch, their values are packed into the word in a loop
+		// without branches, which the compiler vectorizes, and stored at once. Any other edit is a branchless read-modify-write
+		// of its byte
+		inline void apply_bit_edits(std::byte* ptr, size_t size, std::span<const bit_edit> edits) noexcept {
+			constexpr size_t WORD_BITS{ 64 };
+
+			const bit_edit* edit{ edits.data() };
+			const bit_edit* end{ edit + edits.size() };
+			while (edit != end) {
+				size_t first{ edit->index };
+
+				if (first % WORD_BITS == 0 && static_cast<size_t>(end - edit) >= WORD_BITS && edit[WORD_BITS - 1].index == first + WORD_BITS - 1) {
+					std::uint64_t word{ 0 };
+					size_t mismatch{ 0 };
+
+					for (size_t lane{ 0 }; lane < WORD_BITS; ++lane) {
+						word |= std::uint64_t{ edit[lane].value } << lane;
+						mismatch |= edit[lane].index ^ (first + lane);
+					}
+
+					if (mismatch == 0) {
+						store_tail_word(ptr, size, first / BITS_PER_BYTE, word);
+						edit += WORD_BITS;
+						continue;
+					}
+				}
+
+				modify_bit_unchecked(ptr, first, edit->value);
+				++edit;
+			}
+		}
+
+		// Reverses the order of <size> bytes starting at <ptr>, swapping byte-reversed 64-bit words from both ends
+		constexpr void reverse_scalar(std::byte* ptr, size_t size) noexcept {
+			size_t first{ 0 };
+			size_t last{ size };
+
+			for (; last - first >= 2 * sizeof(std::uint64_t); first += sizeof(std::uint64_t), last -= sizeof(std::uint64_t)) {
+				std::uint64_t low = load_word(ptr + first);
+				std::uint64_t high = load_word(ptr + last - sizeof(std::uint64_t));
+				store_word(ptr + first, byteswap(high));
+				store_word(ptr + last - sizeof(std::uint64_t), byteswap(low));
+			}
+
+			std::reverse(ptr + first, ptr + last);
+		}
+
+#ifdef IMD_X86_SIMD
+		// Reverses the 32 bytes of <block>: PSHUFB reverses each 128-bit lane and VPERMQ swaps the lanes
+		__attribute__((target("avx2")))
+		inline __m256i reverse_block_avx2(__m256i block) noexcept {
+			const __m256i reverse_lanes = _mm256_setr_epi8(
+				15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+				15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(block, reverse_lanes), 0x4E);
+		}
+
+		// Reverses the order of <size> bytes starting at <ptr>, swapping reversed 32-byte blocks from both ends
+		__attribute__((target("avx2")))
+		inline void reverse_avx2(std::byte* ptr, size_t size) noexcept {
+			size_t first{ 0 };
+			size_t last{ size };
+
+			for (; last - first >= 2 * sizeof(__m256i); first += sizeof(__m256i), last -= sizeof(__m256i)) {
+				auto low = reinterpret_cast<__m256i*>(ptr + first);
+				auto high = reinterpret_cast<__m256i*>(ptr + last - sizeof(__m256i));
+				__m256i low_block = _mm256_loadu_si256(low);
+				__m256i high_block = _mm256_loadu_si256(high);
+				_mm256_storeu_si256(low, reverse_block_avx2(high_block));
+				_mm256_storeu_si256(high, reverse_block_avx2(low_block));
+			}
+
+			reverse_scalar(ptr + first, last - first);
+		}
+#endif
+
+		// Reverses the order of <size> bytes starting at <ptr>, picking the widest kernel the CPU supports
+		inline void reverse(std::byte* ptr, size_t size) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<void(std::byte*, size_t)>(cpu::implementation(cpu::kernel::reverse), { reverse_scalar, nullptr, nullptr, reverse_avx2, nullptr });
+			if (size >= SIMD_THRESHOLD) {
+				bulk(ptr, size);
+				return;
+			}
+#endif
+			reverse_scalar(ptr, size);
+		}
+
+		// Reverses the bytes of each of the <count> elements of <element_size> bytes starting at <ptr>
+		inline void byte_swap_elements_scalar(std::byte* ptr, size_t count, size_t element_size) noexcept {
+			auto swap_all = [ptr, count]<typename U>(U) {
+				for (size_t i{ 0 }; i < count; ++i) {
+					U word;
+					std::memcpy(&word, ptr + i * sizeof(U), sizeof(U));
+					word = byteswap(word);
+					std::memcpy(ptr + i * sizeof(U), &word, sizeof(U));
+				}
+			};
+
+			switch (element_size) {
+			case 1: break;
+			case 2: swap_all(std::uint16_t{}); break;
+			case 4: swap_all(std::uint32_t{}); break;
+			case 8: swap_all(std::uint64_t{}); break;
+			default:
+				for (size_t i{ 0 }; i < count; ++i)
+					reverse_scalar(ptr + i * element_size, element_size);
+			}
+		}
+
+#ifdef IMD_X86_SIMD
+		// Reverses the bytes of each of the <count> elements of 2, 4, 8 or 16 bytes starting at <ptr>, 32 bytes per PSHUFB
+		__attribute__((target("avx2")))
+		inline void byte_swap_elements_avx2(std::byte* ptr, size_t count, size_t element_size) noexcept {
+			alignas(32) char indices[32];
+			for (size_t i{ 0 }; i < sizeof(indices); ++i)
+				indices[i] = static_cast<char>(i % 16 / element_size * element_size + element_size - 1 - i % element_size);
+
+			const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(indices));
+			const size_t size{ count * element_size };
+			size_t i{ 0 };
+
+			for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+				auto block = reinterpret_cast<__m256i*>(ptr + i);
+				_mm256_storeu_si256(block, _mm256_shuffle_epi8(_mm256_loadu_si256(block), shuffle));
+			}
+
+			byte_swap_elements_scalar(ptr + i, (size - i) / element_size, element_size);
+		}
+#endif
+
+		// Reverses the bytes of each of the <count> elements of <element_size> bytes starting at <ptr>, picking the widest kernel the CPU supports
+		inline void byte_swap_elements(std::byte* ptr, size_t count, size_t element_size) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<void(std::byte*, size_t, size_t)>(
+				cpu::implementation(cpu::kernel::byte_swap), { byte_swap_elements_scalar, nullptr, nullptr, byte_swap_elements_avx2, nullptr });
+			bool fits_lane{ element_size == 2 || element_size == 4 || element_size == 8 || element_size == 16 };
+			if (fits_lane && count * element_size >= SIMD_THRESHOLD) {
+				bulk(ptr, count, element_size);
+				return;
+			}
+#endif
+			byte_swap_elements_scalar(ptr, count, element_size);
+		}
+
+		// Checks that every field of <fields> lies inside an object of <size> bytes
+		inline void validate_fields(std::span<const field> fields, size_t size) {
+			for (const auto& f : fields)
+				if (f.offset > size || f.size > size - f.offset)
+					raise<std::runtime_error>("Field is outside the size of the value");
+		}
+
+		// Reverses the bytes of every field of <fields> in each of the <count> elements of <element_size> bytes starting at <ptr>
+		inline void byte_swap_fields(std::byte* ptr, size_t count, size_t element_size, std::span<const field> fields) {
+			validate_fields(fields, element_size);
+
+			for (size_t i{ 0 }; i < count; ++i, ptr += element_size)
+				for (const auto& f : fields)
+					byte_swap_elements_scalar(ptr + f.offset, 1, f.size);
+		}
+
+		// Returns the byte at <index> of the <size> bytes starting at <ptr>, or zero if <index> is outside the range
+		constexpr unsigned char byte_or_zero(const std::byte* ptr, size_t size, std::ptrdiff_t index) noexcept {
+			return index >= 0 && static_cast<size_t>(index) < size ? static_cast<unsigned char>(ptr[index]) : 0;
+		}
+
+#ifdef IMD_X86_SIMD
+		// Writes 32 bytes per iteration of a left shift by whole bytes plus <bit_shift> (1-7) bits, downwards from the word at <offset>.
+		// Every 64-bit lane is funnel-shifted with the lane 8 bytes below it; the unaligned loads do the cross-lane movement.
+		// Returns the offset of the highest word that is still to be written
+		__attribute__((target("avx2")))
+		inline std::ptrdiff_t shift_left_avx2(std::byte* dst, const std::byte* src, std::ptrdiff_t offset, std::ptrdiff_t byte_shift, unsigned bit_shift) noexcept {
+			const __m128i left = _mm_cvtsi32_si128(static_cast<int>(bit_shift));
+			const __m128i right = _mm_cvtsi32_si128(static_cast<int>(64 - bit_shift));
+
+			for (std::ptrdiff_t block{ offset - 24 }; block - byte_shift - 8 >= 0; block -= 32, offset -= 32) {
+				__m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + block - byte_shift));
+				__m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + block - byte_shift - 8));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + block), _mm256_or_si256(_mm256_sll_epi64(high, left), _mm256_srl_epi64(low, right)));
+			}
+			return offset;
+		}
+
+		// Writes 32 bytes per iteration of a right shift by whole bytes plus <bit_shift> (1-7) bits, upwards from the word at <offset>.
+		// Returns the offset of the lowest word that is still to be written
+		__attribute__((target("avx2")))
+		inline size_t shift_right_avx2(std::byte* dst, const std::byte* src, size_t size, size_t offset, size_t byte_shift, unsigned bit_shift) noexcept {
+			const __m128i right = _mm_cvtsi32_si128(static_cast<int>(bit_shift));
+			const __m128i left = _mm_cvtsi32_si128(static_cast<int>(64 - bit_shift));
+
+			for (; offset + byte_shift + 8 + 32 <= size; offset += 32) {
+				__m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset + byte_shift));
+				__m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset + byte_shift + 8));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset), _mm256_or_si256(_mm256_srl_epi64(low, right), _mm256_sll_epi64(high, left)));
+			}
+			return offset;
+		}
+#endif
+
+		// Writes the <size> bytes starting at <src> shifted to the left (towards higher bit indices) by <shift> positions to <dst>.
+		// The whole-byte part and the bit part are done in a single pass over 64-bit words, from the top down, so <dst> may be equal to <src>
+		constexpr void shift_left(std::byte* dst, const std::byte* src, size_t size, size_t shift) noexcept {
+			if (shift >= size * BITS_PER_BYTE) { // If shift amount is greater or equal to total bits, zero the whole range
+				std::fill(dst, dst + size, std::byte{ 0 });
+				return;
+			}
+
+			size_t byte_shift{ shift / BITS_PER_BYTE };
+			unsigned bit_shift{ static_cast<unsigned>(shift % BITS_PER_BYTE) };
+
+			if (bit_shift == 0) { // Whole bytes only: one move and a zero fill of the leading bytes
+				std::copy_backward(src, src + size - byte_shift, dst + size);
+				std::fill(dst, dst + byte_shift, std::byte{ 0 });
+				return;
+			}
+
+			auto bytes = static_cast<std::ptrdiff_t>(byte_shift);
+			auto offset = static_cast<std::ptrdiff_t>(size) - static_cast<std::ptrdiff_t>(sizeof(std::uint64_t));
+
+#ifdef IMD_X86_SIMD
+			if (!std::is_constant_evaluated() && size >= SIMD_THRESHOLD && cpu::implementation(cpu::kernel::shift) == cpu::isa::avx2)
+				offset = shift_left_avx2(dst, src, offset, bytes, bit_shift);
+#endif
+
+			for (; offset - bytes - 8 >= 0; offset -= 8) // Both source words are inside the range
+				store_word(dst + offset, (load_word(src + offset - bytes) << bit_shift) | (load_word(src + offset - bytes - 8) >> (64 - bit_shift)));
+
+			for (std::ptrdiff_t i{ offset + 7 }; i >= bytes; --i) // The remaining bytes above the zero-filled ones
+				dst[i] = static_cast<std::byte>((byte_or_zero(src, size, i - bytes) << bit_shift) | (byte_or_zero(src, size, i - bytes - 1) >> (BITS_PER_BYTE - bit_shift)));
+
+			std::fill(dst, dst + byte_shift, std::byte{ 0 });
+		}
+
+		// Writes the <size> bytes starting at <src> shifted to the right (towards lower bit indices) by <shift> positions to <dst>.
+		// The whole-byte part and the bit part are done in a single pass over 64-bit words, from the bottom up, so <dst> may be equal to <src>
+		constexpr void shift_right(std::byte* dst, const std::byte* src, size_t size, size_t shift) noexcept {
+			if (shift >= size * BITS_PER_BYTE) { // If shift amount is greater or equal to total bits, zero the whole range
+				std::fill(dst, dst + size, std::byte{ 0 });
+				return;
+			}
+
+			size_t byte_shift{ shift / BITS_PER_BYTE };
+			unsigned bit_shift{ static_cast<unsigned>(shift % BITS_PER_BYTE) };
+
+			if (bit_shift == 0) { // Whole bytes only: one move and a zero fill of the trailing bytes
+				std::copy(src + byte_shift, src + size, dst);
+				std::fill(dst + size - byte_shift, dst + size, std::byte{ 0 });
+				return;
+			}
+
+			size_t offset{ 0 };
+
+#ifdef IMD_X86_SIMD
+			if (!std::is_constant_evaluated() && size >= SIMD_THRESHOLD && cpu::implementation(cpu::kernel::shift) == cpu::isa::avx2)
+				offset = shift_right_avx2(dst, src, size, offset, byte_shift, bit_shift);
+#endif
+
+			for (; offset + byte_shift + 16 <= size; offset += 8) // Both source words are inside the range
+				store_word(dst + offset, (load_word(src + offset + byte_shift) >> bit_shift) | (load_word(src + offset + byte_shift + 8) << (64 - bit_shift)));
+
+			auto bytes = static_cast<std::ptrdiff_t>(byte_shift);
+			for (auto i = static_cast<std::ptrdiff_t>(offset); i < static_cast<std::ptrdiff_t>(size - byte_shift); ++i) // The remaining bytes below the zero-filled ones
+				dst[i] = static_cast<std::byte>((byte_or_zero(src, size, i + bytes) >> bit_shift) | (byte_or_zero(src, size, i + bytes + 1) << (BITS_PER_BYTE - bit_shift)));
+
+			std::fill(dst + size - byte_shift, dst + size, std::byte{ 0 });
+		}
+
+		// Rotates the bits of <size> bytes starting at <ptr> to the left (towards higher bit indices) by <shift> positions
+		constexpr void rotate_left(std::byte* ptr, size_t size, size_t shift) noexcept {
+			if (size == 0) return;
+
+			shift %= size * BITS_PER_BYTE;
+			size_t byte_shift{ shift / BITS_PER_BYTE };
+			unsigned bit_shift{ static_cast<unsigned>(shift % BITS_PER_BYTE) };
+
+			std::rotate(ptr, ptr + size - byte_shift, ptr + size);
+
+			if (bit_shift > 0) { // The bits shifted out of the last byte come back in at the bottom of the first one
+				auto carry = static_cast<unsigned char>(ptr[size - 1]) >> (BITS_PER_BYTE - bit_shift);
+				shift_left(ptr, ptr, size, bit_shift);
+				ptr[0] |= static_cast<std::byte>(carry);
+			}
+		}
+
+		// Rotates the bits of <size> bytes starting at <ptr> to the right (towards lower bit indices) by <shift> positions
+		constexpr void rotate_right(std::byte* ptr, size_t size, size_t shift) noexcept {
+			if (size == 0) return;
+
+			shift %= size * BITS_PER_BYTE;
+			size_t byte_shift{ shift / BITS_PER_BYTE };
+			unsigned bit_shift{ static_cast<unsigned>(shift % BITS_PER_BYTE) };
+
+			std::rotate(ptr, ptr + byte_shift, ptr + size);
+
+			if (bit_shift > 0) { // The bits shifted out of the first byte come back in at the top of the last one
+				auto carry = static_cast<unsigned char>(static_cast<unsigned char>(ptr[0]) << (BITS_PER_BYTE - bit_shift));
+				shift_right(ptr, ptr, size, bit_shift);
+				ptr[size - 1] |= static_cast<std::byte>(carry);
+			}
+		}
+
+		// Rotates the native unsigned integer <word> to the left by <shift> positions
+		template<typename U>
+		constexpr U rotate_left_native(U word, size_t shift) noexcept {
+			constexpr size_t BITS{ sizeof(U) * BITS_PER_BYTE };
+			shift %= BITS;
+			return shift == 0 ? word : static_cast<U>((word << shift) | (word >> (BITS - shift)));
+		}
+
+		// Rotates the native unsigned integer <word> to the right by <shift> positions
+		template<typename U>
+		constexpr U rotate_right_native(U word, size_t shift) noexcept {
+			constexpr size_t BITS{ sizeof(U) * BITS_PER_BYTE };
+			shift %= BITS;
+			return shift == 0 ? word : static_cast<U>((word >> shift) | (word << (BITS - shift)));
+		}
+
+		// The number of characters buffered on the stack before the print functions write them out
+		constexpr size_t PRINT_BUFFER_SIZE{ 4096 };
+
+		// The textual formats the bytes of an object can be written in
+		// <bits> writes the bits of each byte from the most significant one, <bits_lsb_first> in the order of their numbering
+		enum class byte_format { hex, dec, oct, bin, bits, bits_lsb_first };
+
+		// Digits of every byte value: two hexadecimal digits, three octal digits and eight binary digits in both orders
+		inline constexpr auto HEX_DIGITS = [] {
+			std::array<std::array<char, 2>, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte) {
+				table[byte][0] = "0123456789abcdef"[byte >> 4];
+				table[byte][1] = "0123456789abcdef"[byte & 0xF];
+			}
+			return table;
+		}();
+
+		inline constexpr auto OCT_DIGITS = [] {
+			std::array<std::array<char, 3>, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte) {
+				table[byte][0] = static_cast<char>('0' + (byte >> 6));
+				table[byte][1] = static_cast<char>('0' + ((byte >> 3) & 7));
+				table[byte][2] = static_cast<char>('0' + (byte & 7));
+			}
+			return table;
+		}();
+
+		inline constexpr auto BIN_DIGITS = [] {
+			std::array<std::array<char, BITS_PER_BYTE>, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte)
+				for (size_t j{ 0 }; j < BITS_PER_BYTE; ++j)
+					table[byte][BITS_PER_BYTE - 1 - j] = static_cast<char>('0' + ((byte >> j) & 1));
+			return table;
+		}();
+
+		inline constexpr auto BIN_DIGITS_LSB_FIRST = [] {
+			std::array<std::array<char, BITS_PER_BYTE>, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte)
+				for (size_t j{ 0 }; j < BITS_PER_BYTE; ++j)
+					table[byte][j] = static_cast<char>('0' + ((byte >> j) & 1));
+			return table;
+		}();
+
+		// Decimal digits of every byte value without leading zeros, followed by the number of digits
+		inline constexpr auto DEC_DIGITS = [] {
+			std::array<std::array<char, 4>, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte) {
+				char digits[3]{ static_cast<char>('0' + byte / 100), static_cast<char>('0' + byte / 10 % 10), static_cast<char>('0' + byte % 10) };
+				size_t length{ byte >= 100 ? 3u : byte >= 10 ? 2u : 1u };
+				for (size_t j{ 0 }; j < length; ++j)
+					table[byte][j] = digits[3 - length + j];
+				table[byte][3] = static_cast<char>(length);
+			}
+			return table;
+		}();
+
+		// Returns the number of characters <byte> takes in <Format>
+		template<byte_format Format>
+		constexpr size_t formatted_width(unsigned char byte) noexcept {
+			if constexpr (Format == byte_format::hex) return 4;
+			else if constexpr (Format == byte_format::dec) return static_cast<size_t>(DEC_DIGITS[byte][3]);
+			else if constexpr (Format == byte_format::oct) return 4;
+			else if constexpr (Format == byte_format::bin) return 2 + BITS_PER_BYTE;
+			else return BITS_PER_BYTE;
+		}
+
+		// The largest number of characters one byte takes in <Format>
+		template<byte_format Format>
+		constexpr size_t MAX_FORMATTED_WIDTH{ Format == byte_format::dec ? 3 : formatted_width<Format>(0) };
+
+		// Writes <byte> in <Format> to <out> and returns the position after the last written character
+		template<byte_format Format>
+		char* format_byte(char* out, unsigned char byte) noexcept {
+			if constexpr (Format == byte_format::hex) {
+				*out++ = '0';
+				*out++ = 'x';
+				std::memcpy(out, HEX_DIGITS[byte].data(), 2);
+				return out + 2;
+			}
+			else if constexpr (Format == byte_format::dec) {
+				std::memcpy(out, DEC_DIGITS[byte].data(), 3);
+				return out + static_cast<size_t>(DEC_DIGITS[byte][3]);
+			}
+			else if constexpr (Format == byte_format::oct) {
+				*out++ = '0';
+				std::memcpy(out, OCT_DIGITS[byte].data(), 3);
+				return out + 3;
+			}
+			else if constexpr (Format == byte_format::bin) {
+				*out++ = '0';
+				*out++ = 'b';
+				std::memcpy(out, BIN_DIGITS[byte].data(), BITS_PER_BYTE);
+				return out + BITS_PER_BYTE;
+			}
+			else if constexpr (Format == byte_format::bits) {
+				std::memcpy(out, BIN_DIGITS[byte].data(), BITS_PER_BYTE);
+				return out + BITS_PER_BYTE;
+			}
+			else {
+				std::memcpy(out, BIN_DIGITS_LSB_FIRST[byte].data(), BITS_PER_BYTE);
+				return out + BITS_PER_BYTE;
+			}
+		}
+
+		// True for the formats that write eight binary digits per byte and nothing else
+		template<byte_format Format>
+		constexpr bool IS_BIT_FORMAT{ Format == byte_format::bits || Format == byte_format::bits_lsb_first };
+
+		// Writes the bits of <size> bytes starting at <ptr> in <Format> to <out> without separators, one table entry per byte
+		template<byte_format Format>
+		char* expand_bits_scalar(const std::byte* ptr, size_t size, char* out) noexcept {
+			for (size_t i{ 0 }; i < size; ++i)
+				out = format_byte<Format>(out, static_cast<unsigned char>(ptr[i]));
+			return out;
+		}
+
+#ifdef IMD_X86_SIMD
+		// Writes 32 binary digits (4 bytes) per iteration: each byte is broadcast to eight lanes (PSHUFB), tested against
+		// a per-lane bit mask and the comparison result is turned into '0' or '1'
+		template<byte_format Format>
+		__attribute__((target("avx2")))
+		char* expand_bits_avx2(const std::byte* ptr, size_t size, char* out) noexcept {
+			const __m256i spread = _mm256_setr_epi8(
+				0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+				2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+			const __m256i masks = Format == byte_format::bits
+				? _mm256_set1_epi64x(static_cast<long long>(0x0102040810204080ULL))
+				: _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+			const __m256i zeros = _mm256_set1_epi8('0');
+			size_t i{ 0 };
+
+			for (; i + 4 <= size; i += 4, out += 32) {
+				std::uint32_t word;
+				std::memcpy(&word, ptr + i, sizeof(word));
+
+				__m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(word)), spread);
+				__m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, masks), masks);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_sub_epi8(zeros, set));
+			}
+
+			return expand_bits_scalar<Format>(ptr + i, size - i, out);
+		}
+#endif
+
+		// Writes the bits of <size> bytes starting at <ptr> in <Format> to <out> without separators
+		template<byte_format Format>
+		char* expand_bits(const std::byte* ptr, size_t size, char* out) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<char*(const std::byte*, size_t, char*)>(
+				cpu::implementation(cpu::kernel::expand_bits), { expand_bits_scalar<Format>, nullptr, nullptr, expand_bits_avx2<Format>, nullptr });
+			if (size >= 4)
+				return bulk(ptr, size, out);
+#endif
+			return expand_bits_scalar<Format>(ptr, size, out);
+		}
+
+		// The bits of every byte value as eight bytes of 0 or 1, in the order of their numbering
+		inline constexpr auto UNPACKED_BITS = [] {
+			std::array<std::array<std::uint8_t, BITS_PER_BYTE>, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte)
+				for (size_t bit{ 0 }; bit < BITS_PER_BYTE; ++bit)
+					table[byte][bit] = static_cast<std::uint8_t>((byte >> bit) & 1);
+			return table;
+		}();
+
+		// Writes the bits of <size> bytes starting at <ptr> to <out> as one byte of 0 or 1 each, eight at a time from the table
+		inline void unpack_bits_scalar(const std::byte* ptr, size_t size, std::uint8_t* out) noexcept {
+			for (size_t i{ 0 }; i < size; ++i, out += BITS_PER_BYTE)
+				std::memcpy(out, UNPACKED_BITS[static_cast<unsigned char>(ptr[i])].data(), BITS_PER_BYTE);
+		}
+
+		// Sets the bits of <size> bytes starting at <ptr> from size * 8 bytes starting at <in>, a bit being 1 where its byte is not 0.
+		// Each 8 input bytes are read as one word: the highest bit of every byte is set if the byte is not 0, and one multiplication
+		// gathers those eight bits into the top byte
+		inline void pack_bits_scalar(const std::uint8_t* in, std::byte* ptr, size_t size) noexcept {
+			constexpr std::uint64_t LOW_SEVEN{ 0x7F7F7F7F7F7F7F7F };
+			constexpr std::uint64_t HIGH{ 0x8080808080808080 };
+			constexpr std::uint64_t GATHER{ 0x0102040810204080 };
+
+			for (size_t i{ 0 }; i < size; ++i, in += BITS_PER_BYTE) {
+				std::uint64_t word{ load_word(reinterpret_cast<const std::byte*>(in)) };
+				std::uint64_t nonzero{ (((word & LOW_SEVEN) + LOW_SEVEN) | word) & HIGH };
+				ptr[i] = static_cast<std::byte>(((nonzero >> 7) * GATHER) >> 56);
+			}
+		}
+
+#ifdef IMD_X86_SIMD
+		// Writes 32 bits (4 bytes) per iteration: each byte is broadcast to eight lanes (PSHUFB), tested against a per-lane bit mask,
+		// and the comparison result is turned into 0 or 1
+		__attribute__((target("avx2")))
+		inline void unpack_bits_avx2(const std::byte* ptr, size_t size, std::uint8_t* out) noexcept {
+			const __m256i spread = _mm256_setr_epi8(
+				0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+				2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+			const __m256i masks = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+			const __m256i ones = _mm256_set1_epi8(1);
+			size_t i{ 0 };
+
+			for (; i + 4 <= size; i += 4, out += 32) {
+				std::uint32_t word;
+				std::memcpy(&word, ptr + i, sizeof(word));
+
+				__m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(word)), spread);
+				__m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, masks), masks);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_and_si256(set, ones));
+			}
+
+			unpack_bits_scalar(ptr + i, size - i, out);
+		}
+
+		// Writes 64 bits (8 bytes) per iteration by expanding a 64-bit mask into bytes of all ones (VPMOVM2B) and keeping their lowest bit
+		__attribute__((target("avx512f,avx512bw")))
+		inline void unpack_bits_avx512(const std::byte* ptr, size_t size, std::uint8_t* out) noexcept {
+			const __m512i ones = _mm512_set1_epi8(1);
+			size_t i{ 0 };
+
+			for (; i + 8 <= size; i += 8, out += 64)
+				_mm512_storeu_si512(out, _mm512_and_si512(_mm512_movm_epi8(static_cast<__mmask64>(load_word(ptr + i))), ones));
+
+			unpack_bits_scalar(ptr + i, size - i, out);
+		}
+
+		// Packs 32 bytes into 32 bits per iteration: the bytes equal to 0 are found with one comparison and gathered with PMOVMSKB
+		__attribute__((target("avx2")))
+		inline void pack_bits_avx2(const std::uint8_t* in, std::byte* ptr, size_t size) noexcept {
+			const __m256i zeros = _mm256_setzero_si256();
+			size_t i{ 0 };
+
+			for (; i + 4 <= size; i += 4, in += 32) {
+				__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+				auto word = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, zeros)));
+				std::memcpy(ptr + i, &word, sizeof(word));
+			}
+
+			pack_bits_scalar(in, ptr + i, size - i);
+		}
+
+		// Packs 64 bytes into 64 bits per iteration with one VPTESTMB
+		__attribute__((target("avx512f,avx512bw")))
+		inline void pack_bits_avx512(const std::uint8_t* in, std::byte* ptr, size_t size) noexcept {
+			size_t i{ 0 };
+
+			for (; i + 8 <= size; i += 8, in += 64) {
+				__m512i bytes = _mm512_loadu_si512(in);
+				store_word(ptr + i, static_cast<std::uint64_t>(_mm512_test_epi8_mask(bytes, bytes)));
+			}
+
+			pack_bits_scalar(in, ptr + i, size - i);
+		}
+#endif
+
+		// Writes the bits of <size> bytes starting at <ptr> to <out> as one byte of 0 or 1 each, picking the widest kernel the CPU supports
+		inline void unpack_bits(const std::byte* ptr, size_t size, std::uint8_t* out) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<void(const std::byte*, size_t, std::uint8_t*)>(
+				cpu::implementation(cpu::kernel::unpack_bits), { unpack_bits_scalar, nullptr, nullptr, unpack_bits_avx2, unpack_bits_avx512 });
+			if (size >= 4) {
+				bulk(ptr, size, out);
+				return;
+			}
+#endif
+			unpack_bits_scalar(ptr, size, out);
+		}
+
+		// Sets the bits of <size> bytes starting at <ptr> from size * 8 bytes starting at <in>, a bit being 1 where its byte is not 0,
+		// picking the widest kernel the CPU supports
+		inline void pack_bits(const std::uint8_t* in, std::byte* ptr, size_t size) noexcept {
+#ifdef IMD_X86_SIMD
+			static const auto bulk = select_kernel<void(const std::uint8_t*, std::byte*, size_t)>(
+				cpu::implementation(cpu::kernel::pack_bits), { pack_bits_scalar, nullptr, nullptr, pack_bits_avx2, pack_bits_avx512 });
+			if (size >= 4) {
+				bulk(in, ptr, size);
+				return;
+			}
+#endif
+			pack_bits_scalar(in, ptr, size);
+		}
+
+		// Element types any byte can be copied into with memcpy: one-byte integers other than bool, and std::byte. A bool may only
+		// hold 0 or 1, so bytes are converted into it one by one
+		template<typename U>
+		concept byte_element = sizeof(U) == 1 && !std::is_same_v<std::remove_cv_t<U>, bool> && (std::is_integral_v<U> || std::is_same_v<std::remove_cv_t<U>, std::byte>);
+
+		// Element types a bit can be copied into as a byte of 0 or 1: the byte_element types and bool
+		template<typename U>
+		concept bit_element = byte_element<U> || std::is_same_v<std::remove_cv_t<U>, bool>;
+
+		// Iterators over contiguous elements that can be written through
+		template<typename It>
+		concept contiguous_output = std::contiguous_iterator<It> && !std::is_const_v<std::remove_reference_t<std::iter_reference_t<It>>>;
+
+		// Contiguous outputs the conversions write bytes into with memcpy
+		template<typename It>
+		concept contiguous_byte_output = contiguous_output<It> && byte_element<std::iter_value_t<It>>;
+
+		// Contiguous outputs the conversions write bits into as bytes of 0 or 1
+		template<typename It>
+		concept contiguous_bit_output = contiguous_output<It> && bit_element<std::iter_value_t<It>>;
+
+		// Writes <byte> through <out>, as a number unless <out> only takes std::byte
+		template<typename OutputIt>
+		void write_byte(OutputIt& out, unsigned char byte) {
+			if constexpr (std::indirectly_writable<OutputIt, unsigned char>)
+				*out = byte;
+			else
+				*out = static_cast<std::byte>(byte);
+			++out;
+		}
+
+		// Returns the exact number of characters <size> bytes starting at <ptr> take in <Format>, each followed by <separator>
+		template<byte_format Format>
+		size_t formatted_size(const std::byte* ptr, size_t size, std::string_view separator) noexcept {
+			if constexpr (Format == byte_format::dec) {
+				size_t digits{ 0 };
+				for (size_t i{ 0 }; i < size; ++i)
+					digits += formatted_width<Format>(static_cast<unsigned char>(ptr[i]));
+				return digits + size * separator.size();
+			}
+			else
+				return size * (formatted_width<Format>(0) + separator.size());
+		}
+
+		// Writes <size> bytes starting at <ptr> in <Format> to [first, last), each followed by <separator>
+		template<byte_format Format>
+		std::to_chars_result format_bytes(char* first, char* last, const std::byte* ptr, size_t size, std::string_view separator) noexcept {
+			if constexpr (IS_BIT_FORMAT<Format>) {
+				if (separator.empty()) {
+					if (static_cast<size_t>(last - first) < size * BITS_PER_BYTE)
+						return { last, std::errc::value_too_large };
+					return { expand_bits<Format>(ptr, size, first), std::errc{} };
+				}
+			}
+
+			for (size_t i{ 0 }; i < size; ++i) {
+				auto byte = static_cast<unsigned char>(ptr[i]);
+				if (static_cast<size_t>(last - first) < formatted_width<Format>(byte) + separator.size())
+					return { last, std::errc::value_too_large };
+
+				first = format_byte<Format>(first, byte);
+				first = std::copy(separator.begin(), separator.end(), first);
+			}
+			return { first, std::errc{} };
+		}
+
+		// Writes <size> characters starting at <data> to the stream <out>
+		inline void write(std::ostream& out, const char* data, size_t size) {
+			out.write(data, static_cast<std::streamsize>(size));
+		}
+
+#if __has_include(<unistd.h>)
+		// Writes <size> characters starting at <data> to the file descriptor <out>, retrying partial and interrupted writes
+		inline void write(file_descriptor out, const char* data, size_t size) {
+			while (size > 0) {
+				auto written = ::write(out.fd, data, size);
+				if (written < 0) {
+					if (errno == EINTR)
+						continue;
+					raise<std::system_error>(errno, std::generic_category(), "Failed to write to the file descriptor");
+				}
+				data += written;
+				size -= static_cast<size_t>(written);
+			}
+		}
+#endif
+
+		// Prints <size> bytes starting at <ptr> in <Format> to <out>, each followed by <separator>, and optionally a newline
+		// The text is rendered into a stack buffer and written out with one call whenever the buffer fills up
+		template<byte_format Format, typename Sink>
+		void print_bytes(Sink&& out, const std::byte* ptr, size_t size, std::string_view separator, bool newline) {
+			char buffer[PRINT_BUFFER_SIZE];
+			char* position{ buffer };
+			char* const end{ buffer + PRINT_BUFFER_SIZE };
+
+			if constexpr (IS_BIT_FORMAT<Format>) {
+				if (separator.empty()) { // Contiguous digits are expanded a buffer at a time
+					constexpr size_t BYTES_PER_BUFFER{ PRINT_BUFFER_SIZE / BITS_PER_BYTE - 1 };
+					for (size_t i{ 0 }; i < size; i += BYTES_PER_BUFFER) {
+						if (position != buffer) {
+							write(out, buffer, static_cast<size_t>(position - buffer));
+							position = buffer;
+						}
+						position = expand_bits<Format>(ptr + i, std::min(BYTES_PER_BUFFER, size - i), buffer);
+					}
+					size = 0;
+				}
+			}
+
+			for (size_t i{ 0 }; i < size; ++i) {
+				if (static_cast<size_t>(end - position) < MAX_FORMATTED_WIDTH<Format> + separator.size()) {
+					write(out, buffer, static_cast<size_t>(position - buffer));
+					position = buffer;
+				}
+
+				position = format_byte<Format>(position, static_cast<unsigned char>(ptr[i]));
+
+				if (separator.size() <= static_cast<size_t>(end - position))
+					position = std::copy(separator.begin(), separator.end(), position);
+				else { // A separator larger than the buffer is written out on its own
+					write(out, buffer, static_cast<size_t>(position - buffer));
+					write(out, separator.data(), separator.size());
+					position = buffer;
+				}
+			}
+
+			if (newline) {
+				if (position == end) {
+					write(out, buffer, static_cast<size_t>(position - buffer));
+					position = buffer;
+				}
+				*position++ = '\n';
+			}
+
+			if (position != buffer)
+				write(out, buffer, static_cast<size_t>(position - buffer));
+		}
+
+		// The character of every byte value in the text column of hexdump: itself if it is printable ASCII, '.' otherwise
+		inline constexpr auto HEXDUMP_CHARACTERS = [] {
+			std::array<char, 256> table{};
+			for (size_t byte{ 0 }; byte < table.size(); ++byte)
+				table[byte] = byte >= 0x20 && byte < 0x7F ? static_cast<char>(byte) : '.';
+			return table;
+		}();
+
+		// The number of characters hexdump renders before writing them out
+		constexpr size_t HEXDUMP_BUFFER_SIZE{ 1 << 16 };
+
+		// Writes <size> bytes starting at <ptr> to <out> as lines of an offset, hexadecimal digits and characters, in the layout
+		// of xxd. The lines are rendered from the digit and character tables into a large block, which is written out with one
+		// call whenever it fills up, and the position of every byte in a line is computed once per call rather than per line
+		template<typename Sink>
+		void hexdump(Sink&& out, const std::byte* ptr, size_t size, const hexdump_options& options) {
+			if (options.width == 0)
+				raise<std::runtime_error>("Hexdump width must not be 0");
+
+			const size_t width{ options.width };
+			size_t last_offset{ options.offset + (size == 0 ? 0 : size - 1) };
+			size_t offset_digits{ 8 };
+			while (offset_digits < 2 * sizeof(size_t) && (last_offset >> (4 * offset_digits)) != 0)
+				offset_digits += 2;
+
+			// Columns of the digits of each byte, relative to the start of the digits, and of the characters
+			std::vector<size_t> digit_columns(width);
+			for (size_t i{ 0 }; i < width; ++i)
+				digit_columns[i] = 2 * i + (options.group == 0 ? 0 : i / options.group);
+			const size_t digits_width{ digit_columns[width - 1] + 2 };
+			const size_t line_size{ offset_digits + 2 + digits_width + 2 + width + 1 };
+
+			std::vector<char> buffer(std::max(HEXDUMP_BUFFER_SIZE, line_size));
+			char* position{ buffer.data() };
+			char* const end{ buffer.data() + buffer.size() };
+
+			auto flush = [&] {
+				write(out, buffer.data(), static_cast<size_t>(position - buffer.data()));
+				position = buffer.data();
+			};
+
+			auto write_line = [&](size_t line_offset, const std::byte* line, size_t count) {
+				if (static_cast<size_t>(end - position) < line_size)
+					flush();
+
+				size_t value{ options.offset + line_offset };
+				for (size_t digit{ offset_digits }; digit > 0; digit -= 2, value >>= 8)
+					std::memcpy(position + digit - 2, HEX_DIGITS[value & 0xFF].data(), 2);
+				position += offset_digits;
+				*position++ = ':';
+				*position++ = ' ';
+
+				std::memset(position, ' ', digits_width + 2);
+				for (size_t i{ 0 }; i < count; ++i)
+					std::memcpy(position + digit_columns[i], HEX_DIGITS[static_cast<unsigned char>(line[i])].data(), 2);
+				position += digits_width + 2;
+
+				for (size_t i{ 0 }; i < count; ++i)
+					*position++ = HEXDUMP_CHARACTERS[static_cast<unsigned char>(line[i])];
+				*position++ = '\n';
+			};
+
+			bool squeezed{ false };
+			for (size_t line_offset{ 0 }; line_offset < size; line_offset += width) {
+				size_t count{ std::min(width, size - line_offset) };
+				const std::byte* line{ ptr + line_offset };
+
+				// A whole line equal to the one before it is folded into the "*" line, except the last line of the dump, which
+				// is always written so the end of the data can be seen
+				bool last{ line_offset + count == size };
+				if (options.squeeze && line_offset != 0 && count == width && !last && std::memcmp(line, line - width, width) == 0) {
+					if (!squeezed) {
+						if (end - position < 2)
+							flush();
+						*position++ = '*';
+						*position++ = '\n';
+						squeezed = true;
+					}
+					continue;
+				}
+
+				squeezed = false;
+				write_line(line_offset, line, count);
+			}
+
+			if (position != buffer.data())
+				flush();
+		}
+
+		// The execution policies of the library
+		template<typename Policy>
+		concept execution_policy = std::is_same_v<Policy, sequenced_policy> || std::is_same_v<Policy, parallel_policy>
+			|| std::is_same_v<Policy, parallel_unsequenced_policy>;
+
+		// The parallel overloads split their ranges into chunks of this many bytes, which fit in the L2 cache of one core
+		constexpr size_t PARALLEL_CHUNK{ 1 << 18 };
+
+		// A pool of one thread less than the hardware has, which runs one loop at a time together with the thread that starts it.
+		// The threads take the iterations of the loop from a shared counter as they finish the previous ones, so a thread that
+		// is slowed down just takes fewer of them and no queue per thread is needed
+		class thread_pool {
+		public:
+			// Returns the pool, starting its threads on first use
+			static thread_pool& instance() {
+				static thread_pool pool;
+				return pool;
+			}
+
+			thread_pool(const thread_pool&) = delete;
+			thread_pool& operator=(const thread_pool&) = delete;
+
+			~thread_pool() {
+				{
+					std::lock_guard lock{ mutex_ };
+					stop_ = true;
+				}
+				wake_.notify_all();
+				for (auto& worker : workers_)
+					worker.join();
+			}
+
+			// Returns the number of threads that can work on a loop, counting the one that starts it
+			size_t size() const noexcept {
+				return workers_.size() + 1;
+			}
+
+			// Calls <task> with every index of [0, count) on up to <threads> threads, including the calling one, and returns when
+			// all the calls have returned. A loop started from inside another one runs on the calling thread only. If a call throws,
+			// the remaining indices are skipped and the first exception is rethrown once every thread has left the loop
+			template<typename F>
+			void run(size_t count, size_t threads, F&& task) {
+				if (threads <= 1 || count <= 1 || inside_) {
+					for (size_t i{ 0 }; i < count; ++i)
+						task(i);
+					return;
+				}
+
+				std::lock_guard run_lock{ run_mutex_ };
+				{
+					std::lock_guard lock{ mutex_ };
+					task_ = &task;
+					invoke_ = [](void* f, size_t i) { (*static_cast<std::remove_reference_t<F>*>(f))(i); };
+					count_ = count;
+					next_.store(0, std::memory_order_relaxed);
+					wanted_ = std::min({ threads, count, size() }) - 1;
+					joined_ = 0;
+					error_ = nullptr;
+					++generation_;
+				}
+				wake_.notify_all();
+
+				{
+					finish guard{ *this };
+					inside_ = true;
+					work();
+				}
+
+				if (error_)
+					std::rethrow_exception(std::exchange(error_, nullptr));
+			}
+
+		private:
+			std::vector<std::thread> workers_;
+			std::mutex run_mutex_;
+			std::mutex mutex_;
+			std::condition_variable wake_;
+			std::condition_variable done_;
+			void (*invoke_)(void*, size_t) { nullptr };
+			void* task_{ nullptr };
+			size_t count_{ 0 };
+			std::atomic<size_t> next_{ 0 };
+			size_t wanted_{ 0 };
+			size_t joined_{ 0 };
+			size_t active_{ 0 };
+			std::uint64_t generation_{ 0 };
+			bool stop_{ false };
+
+			std::exception_ptr error_{};
+
+			static inline thread_local bool inside_{ false };
+
+			// Ends the loop of the calling thread, also when its calls throw: no index is handed out any more, no worker joins any
+			// more, and the destructor returns once the workers that joined have left, since they may still be calling the task
+			struct finish {
+				thread_pool& pool;
+
+				~finish() {
+					inside_ = false;
+					pool.next_.store(pool.count_, std::memory_order_relaxed);
+
+					std::unique_lock lock{ pool.mutex_ };
+					pool.wanted_ = pool.joined_;
+					pool.done_.wait(lock, [this] { return pool.active_ == 0; });
+				}
+			};
+
+			thread_pool() {
+				unsigned threads{ std::max(1u, std::thread::hardware_concurrency()) };
+				for (unsigned i{ 1 }; i < threads; ++i)
+					workers_.emplace_back([this] { serve(); });
+			}
+
+			// Runs iterations of the current loop until there are none left
+			void work() {
+				for (size_t i{ next_.fetch_add(1, std::memory_order_relaxed) }; i < count_; i = next_.fetch_add(1, std::memory_order_relaxed))
+					invoke_(task_, i);
+			}
+
+			// Runs work() on a worker and returns what it threw, after making the other threads skip the indices left
+			std::exception_ptr work_caught() noexcept {
+#if defined(__cpp_exceptions)
+				try {
+					work();
+				}
+				catch (...) {
+					next_.store(count_, std::memory_order_relaxed);
+					return std::current_exception();
+				}
+#else
+				work();
+#endif
+				return nullptr;
+			}
+
+			// Joins every loop that still wants threads, until the pool is destroyed
+			void serve() {
+				inside_ = true;
+				std::uint64_t seen{ 0 };
+				std::unique_lock lock{ mutex_ };
+				for (;;) {
+					wake_.wait(lock, [&] { return stop_ || (generation_ != seen && joined_ < wanted_); });
+					if (stop_)
+						return;
+
+					seen = generation_;
+					++joined_;
+					++active_;
+					lock.unlock();
+					std::exception_ptr error{ work_caught() };
+					lock.lock();
+					if (error && !error_)
+						error_ = error;
+					if (--active_ == 0)
+						done_.notify_all();
+				}
+			}
+		};
+
+		// Returns the number of threads <policy> runs on
+		template<execution_policy Policy>
+		size_t policy_threads(const Policy& policy) {
+			if constexpr (std::is_same_v<Policy, sequenced_policy>)
+				return 1;
+			else
+				return policy.threads == 0 ? thread_pool::instance().size() : policy.threads;
+		}
+
+		// Calls <task>(offset, count) for consecutive chunks of PARALLEL_CHUNK bytes that cover <size> bytes, on the threads of <policy>
+		template<execution_policy Policy, typename F>
+		void for_each_chunk(const Policy& policy, size_t size, F task) {
+			size_t chunks{ (size + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK };
+			size_t threads{ chunks > 1 ? policy_threads(policy) : 1 };
+			auto run_chunk = [&](size_t chunk) {
+				size_t offset{ chunk * PARALLEL_CHUNK };
+				task(offset, std::min(PARALLEL_CHUNK, size - offset));
+			};
+
+			// Sequential loops run inline, so that they never start the pool
+			if (threads <= 1) {
+				for (size_t chunk{ 0 }; chunk < chunks; ++chunk)
+					run_chunk(chunk);
+				return;
+			}
+			thread_pool::instance().run(chunks, threads, run_chunk);
+		}
+
+		// Returns the number of bits set to 1 in <size> bytes starting at <ptr>, counted on the threads of <policy>
+		template<execution_policy Policy>
+		size_t popcount(const Policy& policy, const std::byte* ptr, size_t size) {
+			std::atomic<size_t> total{ 0 };
+			for_each_chunk(policy, size, [&](size_t offset, size_t count) {
+				total.fetch_add(popcount(ptr + offset, count), std::memory_order_relaxed);
+			});
+			return total.load(std::memory_order_relaxed);
+		}
+
+		// Returns true if every one of <size> bytes starting at <ptr> is equal to <pattern>. As soon as one thread finds a byte that
+		// differs, the chunks that have not started yet are skipped
+		template<execution_policy Policy>
+		bool all_bytes_equal(const Policy& policy, const std::byte* ptr, size_t size, std::byte pattern) {
+			std::atomic<bool> differs{ false };
+			for_each_chunk(policy, size, [&](size_t offset, size_t count) {
+				if (!differs.load(std::memory_order_relaxed) && !all_bytes_equal(ptr + offset, count, pattern))
+					differs.store(true, std::memory_order_relaxed);
+			});
+			return !differs.load(std::memory_order_relaxed);
+		}
+
+		// Returns the index of the first bit of <size> bytes starting at <ptr> that is set to 1 (0 if <Zero>), or npos. Chunks after
+		// the first one found so far are skipped
+		template<bool Zero, execution_policy Policy>
+		size_t find_first(const Policy& policy, const std::byte* ptr, size_t size) {
+			std::atomic<size_t> first{ npos };
+			for_each_chunk(policy, size, [&](size_t offset, size_t count) {
+				if (offset * BITS_PER_BYTE >= first.load(std::memory_order_relaxed))
+					return;
+				size_t found{ find_next<Zero>(ptr + offset, count, 0) };
+				if (found == npos)
+					return;
+				found += offset * BITS_PER_BYTE;
+				for (size_t current{ first.load(std::memory_order_relaxed) }; found < current && !first.compare_exchange_weak(current, found, std::memory_order_relaxed);)
+					;
+			});
+			return first.load(std::memory_order_relaxed);
+		}
+
+		// Inverts <size> bytes starting at <ptr> on the threads of <policy>
+		template<execution_policy Policy>
+		void invert(const Policy& policy, std::byte* ptr, size_t size) {
+			for_each_chunk(policy, size, [&](size_t offset, size_t count) { invert(ptr + offset, count); });
+		}
+
+		// Writes <Op> applied to the bytes of <first> and <second> to the bytes of <result>, which must all have the same size,
+		// on the threads of <policy>
+		template<typename Op, execution_policy Policy>
+		void combine(const Policy& policy, std::span<const std::byte> first, std::span<const std::byte> second, std::span<std::byte> result) {
+			if (first.size() != second.size() || first.size() != result.size())
+				raise<std::runtime_error>("Ranges have different sizes");
+
+			for_each_chunk(policy, result.size(), [&](size_t offset, size_t count) {
+				combine<Op>(result.data() + offset, first.data() + offset, second.data() + offset, count);
+			});
+		}
+
+	}
+
+	// Returns the number of bytes of the specified type <T>
+	template<typename T>
+	constexpr size_t byte_count() noexcept {
+		return sizeof(T);
+	}
+
+	// Returns the number of bits of the specified type <T>
+	template<typename T>
+	constexpr size_t bit_count() noexcept {
+		return sizeof(T) * BITS_PER_BYTE;
+	}
+
+	// Writes the bytes of <value> in hexadecimal format into [first, last) in the manner of std::to_chars
+	template<typename T>
+	std::to_chars_result format_hex_bytes(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return detail::format_bytes<detail::byte_format::hex>(first, last, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator);
+	}
+
+	// Writes the bytes of <value> in decimal format into [first, last) in the manner of std::to_chars
+	template<typename T>
+	std::to_chars_result format_dec_bytes(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return detail::format_bytes<detail::byte_format::dec>(first, last, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator);
+	}
+
+	// Writes the bytes of <value> in octal format into [first, last) in the manner of std::to_chars
+	template<typename T>
+	std::to_chars_result format_oct_bytes(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return detail::format_bytes<detail::byte_format::oct>(first, last, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator);
+	}
+
+	// Writes the bytes of <value> in binary format into [first, last) in the manner of std::to_chars
+	template<typename T>
+	std::to_chars_result format_bin_bytes(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return detail::format_bytes<detail::byte_format::bin>(first, last, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator);
+	}
+
+	// Writes the bits of <value> into [first, last) in the manner of std::to_chars
+	template<typename T>
+	std::to_chars_result format_bits(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return detail::format_bytes<detail::byte_format::bits>(first, last, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator);
+	}
+
+	// Prints the bytes of <value> in hexadecimal format to the stream <out> without a trailing newline
+	template<typename T>
+	void print_hex_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::hex>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in hexadecimal format to the file descriptor <out> without a trailing newline
+	template<typename T>
+	void print_hex_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::hex>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+#endif
+
+	// Prints the bytes of <value> in hexadecimal format without a trailing newline
+	template<typename T>
+	void print_hex_bytes(const T& value, const std::string& separator = " "s) {
+		print_hex_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in decimal format to the stream <out> without a trailing newline
+	template<typename T>
+	void print_dec_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::dec>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in decimal format to the file descriptor <out> without a trailing newline
+	template<typename T>
+	void print_dec_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::dec>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+#endif
+
+	// Prints the bytes of <value> in decimal format without a trailing newline
+	template<typename T>
+	void print_dec_bytes(const T& value, const std::string& separator = " "s) {
+		print_dec_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in octal format to the stream <out> without a trailing newline
+	template<typename T>
+	void print_oct_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::oct>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in octal format to the file descriptor <out> without a trailing newline
+	template<typename T>
+	void print_oct_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::oct>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+#endif
+
+	// Prints the bytes of <value> in octal format without a trailing newline
+	template<typename T>
+	void print_oct_bytes(const T& value, const std::string& separator = " "s) {
+		print_oct_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in binary format to the stream <out> without a trailing newline
+	template<typename T>
+	void print_bin_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bin>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in binary format to the file descriptor <out> without a trailing newline
+	template<typename T>
+	void print_bin_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bin>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+#endif
+
+	// Prints the bytes of <value> in binary format without a trailing newline
+	template<typename T>
+	void print_bin_bytes(const T& value, const std::string& separator = " "s) {
+		print_bin_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bits of <value> to the stream <out> without a trailing newline
+	template<typename T>
+	void print_bits(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bits>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bits of <value> to the file descriptor <out> without a trailing newline
+	template<typename T>
+	void print_bits(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bits>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, false);
+	}
+#endif
+
+	// Print the bits of <value> without a trailing newline
+	template<typename T>
+	void print_bits(const T& value, const std::string& separator = " "s) {
+		print_bits(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in hexadecimal format to the stream <out> followed by a newline, without flushing the stream
+	template<typename T>
+	void println_hex_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::hex>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in hexadecimal format to the file descriptor <out> followed by a newline
+	template<typename T>
+	void println_hex_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::hex>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+#endif
+
+	// Prints the bytes of <value> in hexadecimal format followed by a newline
+	template<typename T>
+	void println_hex_bytes(const T& value, const std::string& separator = " "s) {
+		println_hex_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in decimal format to the stream <out> followed by a newline, without flushing the stream
+	template<typename T>
+	void println_dec_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::dec>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in decimal format to the file descriptor <out> followed by a newline
+	template<typename T>
+	void println_dec_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::dec>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+#endif
+
+	// Prints the bytes of <value> in decimal format followed by a newline
+	template<typename T>
+	void println_dec_bytes(const T& value, const std::string& separator = " "s) {
+		println_dec_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in octal format to the stream <out> followed by a newline, without flushing the stream
+	template<typename T>
+	void println_oct_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::oct>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in octal format to the file descriptor <out> followed by a newline
+	template<typename T>
+	void println_oct_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::oct>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+#endif
+
+	// Prints the bytes of <value> in octal format followed by a newline
+	template<typename T>
+	void println_oct_bytes(const T& value, const std::string& separator = " "s) {
+		println_oct_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bytes of <value> in binary format to the stream <out> followed by a newline, without flushing the stream
+	template<typename T>
+	void println_bin_bytes(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bin>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bytes of <value> in binary format to the file descriptor <out> followed by a newline
+	template<typename T>
+	void println_bin_bytes(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bin>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+#endif
+
+	// Prints the bytes of <value> in binary format followed by a newline
+	template<typename T>
+	void println_bin_bytes(const T& value, const std::string& separator = " "s) {
+		println_bin_bytes(std::cout, value, separator);
+	}
+
+	// Prints the bits of <value> to the stream <out> followed by a newline, without flushing the stream
+	template<typename T>
+	void println_bits(std::ostream& out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bits>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+
+#if __has_include(<unistd.h>)
+	// Prints the bits of <value> to the file descriptor <out> followed by a newline
+	template<typename T>
+	void println_bits(file_descriptor out, const T& value, std::string_view separator = " ") {
+		detail::print_bytes<detail::byte_format::bits>(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator, true);
+	}
+#endif
+
+	// Prints the bits of <value> followed by a newline
+	template<typename T>
+	void println_bits(const T& value, const std::string& separator = " "s) {
+		println_bits(std::cout, value, separator);
+	}
+
+	// Writes the bytes of <value> to the stream <out> as a hexdump laid out by <options>
+	template<detail::single_object T>
+	void hexdump(std::ostream& out, const T& value, const hexdump_options& options = {}) {
+		detail::hexdump(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), options);
+	}
+
+	// Writes the bytes of <values> to the stream <out> as a hexdump laid out by <options>
+	template<typename T, size_t Extent>
+	void hexdump(std::ostream& out, std::span<T, Extent> values, const hexdump_options& options = {}) {
+		auto bytes = std::as_bytes(values);
+		detail::hexdump(out, bytes.data(), bytes.size(), options);
+	}
+
+#if __has_include(<unistd.h>)
+	// Writes the bytes of <value> to the file descriptor <out> as a hexdump laid out by <options>
+	template<detail::single_object T>
+	void hexdump(file_descriptor out, const T& value, const hexdump_options& options = {}) {
+		detail::hexdump(out, reinterpret_cast<const std::byte*>(&value), sizeof(T), options);
+	}
+
+	// Writes the bytes of <values> to the file descriptor <out> as a hexdump laid out by <options>. This is the fastest way to
+	// dump large buffers and mapped files, since nothing goes through a stream
+	template<typename T, size_t Extent>
+	void hexdump(file_descriptor out, std::span<T, Extent> values, const hexdump_options& options = {}) {
+		auto bytes = std::as_bytes(values);
+		detail::hexdump(out, bytes.data(), bytes.size(), options);
+	}
+#endif
+
+	// Writes the bytes of <value> to the standard output as a hexdump laid out by <options>
+	template<detail::single_object T>
+	void hexdump(const T& value, const hexdump_options& options = {}) {
+		hexdump(std::cout, value, options);
+	}
+
+	// Writes the bytes of <values> to the standard output as a hexdump laid out by <options>
+	template<typename T, size_t Extent>
+	void hexdump(std::span<T, Extent> values, const hexdump_options& options = {}) {
+		hexdump(std::cout, values, options);
+	}
+
+	// Changes the byte of the supplied <value> with the specified <index>
+	template<typename T>
+	void modify_byte(T& value, size_t index, std::byte new_byte) {
+		detail::modify_byte(reinterpret_cast<std::byte*>(&value), sizeof(T), index, new_byte);
+	}
+
+	// Changes the byte with the specified <index> of the bytes of <values>
+	template<typename T, size_t Extent>
+	void modify_byte(std::span<T, Extent> values, size_t index, std::byte new_byte) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::modify_byte(bytes.data(), bytes.size(), index, new_byte);
+	}
+
+	// Changes the bit of the supplied <value> at the specified <index> to <new_bit>
+	template<typename T>
+	void modify_bit(T& value, size_t index, bool new_bit) {
+		detail::modify_bit(reinterpret_cast<std::byte*>(&value), sizeof(T), index, new_bit);
+	}
+
+	// Changes the bit of the bytes of <values> at the specified <index> to <new_bit>
+	template<typename T, size_t Extent>
+	void modify_bit(std::span<T, Extent> values, size_t index, bool new_bit) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::modify_bit(bytes.data(), bytes.size(), index, new_bit);
+	}
+
+	// Changes the byte of the supplied <value> with the specified <index>, which must be inside <value>. Nothing is checked
+	// except by a debug assertion, so the call compiles to a single store
+	template<typename T>
+	void modify_byte_unchecked(T& value, size_t index, std::byte new_byte) noexcept {
+		assert(index < sizeof(T) && "Byte index is outside the size of the value");
+		detail::modify_byte_unchecked(reinterpret_cast<std::byte*>(&value), index, new_byte);
+	}
+
+	// Changes the byte with the specified <index>, which must be inside them, of the bytes of <values>. Nothing is checked
+	// except by a debug assertion
+	template<typename T, size_t Extent>
+	void modify_byte_unchecked(std::span<T, Extent> values, size_t index, std::byte new_byte) noexcept {
+		assert(index < values.size_bytes() && "Byte index is outside the size of the value");
+		detail::modify_byte_unchecked(std::as_writable_bytes(values).data(), index, new_byte);
+	}
+
+	// Changes the bit of the supplied <value> at the specified <index>, which must be inside <value>, to <new_bit>. Nothing is
+	// checked except by a debug assertion
+	template<typename T>
+	void modify_bit_unchecked(T& value, size_t index, bool new_bit) noexcept {
+		assert(index < bit_count<T>() && "Bit index is outside the size of the value");
+		detail::modify_bit_unchecked(reinterpret_cast<std::byte*>(&value), index, new_bit);
+	}
+
+	// Changes the bit of the bytes of <values> at the specified <index>, which must be inside them, to <new_bit>. Nothing is
+	// checked except by a debug assertion
+	template<typename T, size_t Extent>
+	void modify_bit_unchecked(std::span<T, Extent> values, size_t index, bool new_bit) noexcept {
+		assert(index < values.size_bytes() * BITS_PER_BYTE && "Bit index is outside the size of the value");
+		detail::modify_bit_unchecked(std::as_writable_bytes(values).data(), index, new_bit);
+	}
+
+	// Changes the byte of the supplied <value> with the specified <index> and returns std::errc{}, or returns
+	// std::errc::result_out_of_range without changing anything if <index> is outside <value>
+	template<typename T>
+	std::errc try_modify_byte(T& value, size_t index, std::byte new_byte) noexcept {
+		if (index >= sizeof(T))
+			return std::errc::result_out_of_range;
+
+		detail::modify_byte_unchecked(reinterpret_cast<std::byte*>(&value), index, new_byte);
+		return std::errc{};
+	}
+
+	// Changes the byte with the specified <index> of the bytes of <values> and returns std::errc{}, or returns
+	// std::errc::result_out_of_range without changing anything if <index> is outside them
+	template<typename T, size_t Extent>
+	std::errc try_modify_byte(std::span<T, Extent> values, size_t index, std::byte new_byte) noexcept {
+		if (index >= values.size_bytes())
+			return std::errc::result_out_of_range;
+
+		detail::modify_byte_unchecked(std::as_writable_bytes(values).data(), index, new_byte);
+		return std::errc{};
+	}
+
+	// Changes the bit of the supplied <value> at the specified <index> to <new_bit> and returns std::errc{}, or returns
+	// std::errc::result_out_of_range without changing anything if <index> is outside <value>
+	template<typename T>
+	std::errc try_modify_bit(T& value, size_t index, bool new_bit) noexcept {
+		if (index >= bit_count<T>())
+			return std::errc::result_out_of_range;
+
+		detail::modify_bit_unchecked(reinterpret_cast<std::byte*>(&value), index, new_bit);
+		return std::errc{};
+	}
+
+	// Changes the bit of the bytes of <values> at the specified <index> to <new_bit> and returns std::errc{}, or returns
+	// std::errc::result_out_of_range without changing anything if <index> is outside them
+	template<typename T, size_t Extent>
+	std::errc try_modify_bit(std::span<T, Extent> values, size_t index, bool new_bit) noexcept {
+		if (index >= values.size_bytes() * BITS_PER_BYTE)
+			return std::errc::result_out_of_range;
+
+		detail::modify_bit_unchecked(std::as_writable_bytes(values).data(), index, new_bit);
+		return std::errc{};
+	}
+
+	// Applies <edits> to the bytes of <value> in order, like one modify_byte call per edit, but checks all the indices once before
+	// changing anything
+	template<detail::single_object T>
+	void modify_bytes(T& value, std::span<const byte_edit> edits) {
+		detail::validate_edits(edits, sizeof(T), "Byte index is outside the size of the value");
+		detail::apply_byte_edits(reinterpret_cast<std::byte*>(&value), edits);
+	}
+
+	// Applies <edits> to the bytes of <values> in order, like one modify_byte call per edit, but checks all the indices once before
+	// changing anything
+	template<typename T, size_t Extent>
+	void modify_bytes(std::span<T, Extent> values, std::span<const byte_edit> edits) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::validate_edits(edits, bytes.size(), "Byte index is outside the size of the value");
+		detail::apply_byte_edits(bytes.data(), edits);
+	}
+
+	// Applies <edits> to the bits of <value> in order, like one modify_bit call per edit, but checks all the indices once before
+	// changing anything and packs runs of 64 edits that cover a 64-bit word in order into a single store
+	template<detail::single_object T>
+	void modify_bits(T& value, std::span<const bit_edit> edits) {
+		detail::validate_edits(edits, bit_count<T>(), "Bit index is outside the size of the value");
+		detail::apply_bit_edits(reinterpret_cast<std::byte*>(&value), sizeof(T), edits);
+	}
+
+	// Applies <edits> to the bits of <values> in order, like one modify_bit call per edit, but checks all the indices once before
+	// changing anything and packs runs of 64 edits that cover a 64-bit word in order into a single store
+	template<typename T, size_t Extent>
+	void modify_bits(std::span<T, Extent> values, std::span<const bit_edit> edits) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::validate_edits(edits, bytes.size() * BITS_PER_BYTE, "Bit index is outside the size of the value");
+		detail::apply_bit_edits(bytes.data(), bytes.size(), edits);
+	}
+
+	// Returns the <width> bits of <value> starting at bit <offset> in the lowest bits of a 64-bit word; <width> can be at most 64
+	template<detail::single_object T>
+	constexpr std::uint64_t get_bits(const T& value, size_t offset, size_t width) {
+		detail::validate_bit_field(sizeof(T), offset, width);
+		if constexpr (detail::natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t))
+			return width == 0 ? 0 : static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value)) >> offset & detail::range_mask(0, width);
+		else {
+			if constexpr (detail::bit_castable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					return detail::get_bit_field(bytes.data(), bytes.size(), offset, width);
+				}
+			}
+			return detail::get_bit_field(reinterpret_cast<const std::byte*>(&value), sizeof(T), offset, width);
+		}
+	}
+
+	// Returns the <width> bits of <values> starting at bit <offset> in the lowest bits of a 64-bit word; <width> can be at most 64
+	template<typename T, size_t Extent>
+	std::uint64_t get_bits(std::span<T, Extent> values, size_t offset, size_t width) {
+		auto bytes = std::as_bytes(values);
+		detail::validate_bit_field(bytes.size(), offset, width);
+		return detail::get_bit_field(bytes.data(), bytes.size(), offset, width);
+	}
+
+	// Sets the <width> bits of <value> starting at bit <offset> to the lowest bits of <bits>; <width> can be at most 64
+	template<detail::single_object T>
+	constexpr void set_bits(T& value, size_t offset, size_t width, std::uint64_t bits) {
+		detail::validate_bit_field(sizeof(T), offset, width);
+		if constexpr (detail::natively_assignable<T> && sizeof(T) <= sizeof(std::uint64_t)) {
+			std::uint64_t mask{ detail::range_mask(offset, offset + width) };
+			auto word = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value));
+			word = (word & ~mask) | ((width == 0 ? 0 : bits << offset) & mask);
+			value = std::bit_cast<T>(static_cast<detail::native_word_t<T>>(word));
+		}
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::set_bit_field(bytes.data(), bytes.size(), offset, width, bits);
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			detail::set_bit_field(reinterpret_cast<std::byte*>(&value), sizeof(T), offset, width, bits);
+		}
+	}
+
+	// Sets the <width> bits of <values> starting at bit <offset> to the lowest bits of <bits>; <width> can be at most 64
+	template<typename T, size_t Extent>
+	void set_bits(std::span<T, Extent> values, size_t offset, size_t width, std::uint64_t bits) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::validate_bit_field(bytes.size(), offset, width);
+		detail::set_bit_field(bytes.data(), bytes.size(), offset, width, bits);
+	}
+
+	// Sets the bits [from, to) of <value> to <new_bit>
+	template<detail::single_object T>
+	constexpr void fill_bits(T& value, size_t from, size_t to, bool new_bit) {
+		detail::validate_bit_range(sizeof(T), from, to);
+		if constexpr (detail::natively_assignable<T> && sizeof(T) <= sizeof(std::uint64_t)) {
+			std::uint64_t mask{ detail::range_mask(from, to) };
+			auto word = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value));
+			value = std::bit_cast<T>(static_cast<detail::native_word_t<T>>(new_bit ? word | mask : word & ~mask));
+		}
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::fill_range(bytes.data(), bytes.size(), from, to, new_bit);
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			detail::fill_range(reinterpret_cast<std::byte*>(&value), sizeof(T), from, to, new_bit);
+		}
+	}
+
+	// Sets the bits [from, to) of <values> to <new_bit>. The whole words of the range are filled with a memset
+	template<typename T, size_t Extent>
+	void fill_bits(std::span<T, Extent> values, size_t from, size_t to, bool new_bit) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::validate_bit_range(bytes.size(), from, to);
+		detail::fill_range(bytes.data(), bytes.size(), from, to, new_bit);
+	}
+
+	// Compares the bytes of two values <first> and <second>
+	template<typename T>
+	int compare_bytes(const T& first, const T& second) {
+		return memcmp(&first, &second, sizeof(T));
+	}
+
+	// Compares the bytes of <first> and <second> lexicographically; a shorter range that is a prefix of the longer one compares less
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent>
+	int compare_bytes(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second) {
+		return detail::compare(std::as_bytes(first), std::as_bytes(second));
+	}
+
+	// Compares the bytes of <first> and <second> lexicographically; a shorter range that is a prefix of the longer one compares less
+	template<typename T, size_t Extent>
+	int compare_bytes(std::span<T, Extent> first, std::span<T, Extent> second) {
+		return detail::compare(std::as_bytes(first), std::as_bytes(second));
+	}
+
+	// Swaps the bytes of the given values: <first> and <second>
+	template<typename T>
+	void swap_bytes(T& first, T& second) {
+		auto ptr1 = reinterpret_cast<std::byte*>(&first);
+		auto ptr2 = reinterpret_cast<std::byte*>(&second);
+
+		std::swap_ranges(ptr1, ptr1 + sizeof(T), ptr2);
+	}
+
+	// Swaps the bytes of the given ranges <first> and <second>, which must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent>
+	void swap_bytes(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second) {
+		detail::swap(std::as_writable_bytes(first), std::as_writable_bytes(second));
+	}
+
+	// Swaps the bytes of the given ranges <first> and <second>, which must have the same size in bytes
+	template<typename T, size_t Extent>
+	void swap_bytes(std::span<T, Extent> first, std::span<T, Extent> second) {
+		detail::swap(std::as_writable_bytes(first), std::as_writable_bytes(second));
+	}
+
+	// Writes the text of bytes_to_string into [first, last) in the manner of std::to_chars; the same as format_dec_bytes
+	template<typename T>
+	std::to_chars_result bytes_to_chars(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return format_dec_bytes(first, last, value, separator);
+	}
+
+	// Writes the text of bits_to_string into [first, last) in the manner of std::to_chars: the bits of <value> in the order of their
+	// numbering, lowest first, with a <separator> after every byte. format_bits writes each byte from its highest bit instead
+	template<typename T>
+	std::to_chars_result bits_to_chars(char* first, char* last, const T& value, std::string_view separator = " ") {
+		return detail::format_bytes<detail::byte_format::bits_lsb_first>(first, last, reinterpret_cast<const std::byte*>(&value), sizeof(T), separator);
+	}
+
+	// Returns a string representation of the bytes of <value> with a <separator>
+	template<typename T>
+	std::string bytes_to_string(const T& value, const std::string& separator = " "s) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+		std::string result(detail::formatted_size<detail::byte_format::dec>(ptr, sizeof(T), separator), '\0');
+
+		detail::format_bytes<detail::byte_format::dec>(result.data(), result.data() + result.size(), ptr, sizeof(T), separator);
+		return result;
+	}
+
+	// Returns a string representation of the bits of <value> with a <separator>
+	template<typename T>
+	std::string bits_to_string(const T& value, const std::string& separator = " "s) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+		std::string result(detail::formatted_size<detail::byte_format::bits_lsb_first>(ptr, sizeof(T), separator), '\0');
+
+		detail::format_bytes<detail::byte_format::bits_lsb_first>(result.data(), result.data() + result.size(), ptr, sizeof(T), separator);
+		return result;
+	}
+
+	// Writes the bytes of <value> through <out>, one element per byte, and returns the iterator past the last one. Contiguous
+	// one-byte elements are written with a single memcpy
+	template<typename T, std::input_or_output_iterator OutputIt>
+	OutputIt bytes_to_container(const T& value, OutputIt out) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+
+		if constexpr (detail::contiguous_byte_output<OutputIt>) {
+			std::memcpy(std::to_address(out), ptr, sizeof(T));
+			return out + sizeof(T);
+		}
+		else {
+			for (size_t i{ 0 }; i < sizeof(T); ++i)
+				detail::write_byte(out, static_cast<unsigned char>(ptr[i]));
+			return out;
+		}
+	}
+
+	// Writes the bytes of <value> into <out>, which must have room for sizeof(T) elements, without allocating.
+	// Returns the number of elements written
+	template<typename T, typename U, size_t Extent>
+	size_t bytes_to_container(const T& value, std::span<U, Extent> out) {
+		if (out.size() < sizeof(T))
+			detail::raise<std::runtime_error>("Range is too small for the bytes of the value");
+
+		bytes_to_container(value, out.data());
+		return sizeof(T);
+	}
+
+	// Converts the bytes of <value> into a container. A contiguous container is sized once and written through its data, any
+	// other one is reserved up front where it can be
+	template<typename T, typename C = std::vector<short>>
+	C bytes_to_container(const T& value) {
+		C container{};
+
+		if constexpr (requires { container.resize(sizeof(T)); container.data(); }) {
+			container.resize(sizeof(T));
+			bytes_to_container(value, container.data());
+		}
+		else {
+			if constexpr (requires { container.reserve(sizeof(T)); })
+				container.reserve(sizeof(T));
+			bytes_to_container(value, std::back_inserter(container));
+		}
+
+		return container;
+	}
+
+	// Writes the bits of <value> through <out> in the order of their numbering, one element of 0 or 1 per bit, and returns the
+	// iterator past the last one. Contiguous one-byte elements are filled eight at a time from a table
+	template<typename T, std::input_or_output_iterator OutputIt>
+	OutputIt bits_to_container(const T& value, OutputIt out) {
+		auto ptr = reinterpret_cast<const std::byte*>(&value);
+
+		if constexpr (detail::contiguous_bit_output<OutputIt>) {
+			detail::unpack_bits(ptr, sizeof(T), reinterpret_cast<std::uint8_t*>(std::to_address(out)));
+			return out + bit_count<T>();
+		}
+		else {
+			for (size_t i{ 0 }; i < sizeof(T); ++i)
+				for (size_t j{ 0 }; j < BITS_PER_BYTE; ++j)
+					detail::write_byte(out, (static_cast<unsigned char>(ptr[i]) >> j) & 1);
+			return out;
+		}
+	}
+
+	// Writes the bits of <value> into <out>, which must have room for bit_count<T>() elements, without allocating.
+	// Returns the number of elements written
+	template<typename T, typename U, size_t Extent>
+	size_t bits_to_container(const T& value, std::span<U, Extent> out) {
+		if (out.size() < bit_count<T>())
+			detail::raise<std::runtime_error>("Range is too small for the bits of the value");
+
+		bits_to_container(value, out.data());
+		return bit_count<T>();
+	}
+
+	// Converts the bits of <value> into a container. A contiguous container is sized once and written through its data, any
+	// other one is reserved up front where it can be
+	template<typename T, typename C = std::vector<bool>>
+	C bits_to_container(const T& value) {
+		C container{};
+
+		if constexpr (requires { container.resize(bit_count<T>()); container.data(); }) {
+			container.resize(bit_count<T>());
+			bits_to_container(value, container.data());
+		}
+		else {
+			if constexpr (requires { container.reserve(bit_count<T>()); })
+				container.reserve(bit_count<T>());
+			bits_to_container(value, std::back_inserter(container));
+		}
+
+		return container;
+	}
+
+	// Writes the bits of <value> to <out> in the order of their numbering as bit_count<T>() bytes of 0 or 1, such as an array of
+	// std::uint8_t or bool. Each byte of <value> is spread over eight lanes and compared with their bit masks, 32 or 64 bits at a time
+	template<detail::single_object T, detail::bit_element U>
+	void unpack_bits(const T& value, U* out) noexcept {
+		detail::unpack_bits(reinterpret_cast<const std::byte*>(&value), sizeof(T), reinterpret_cast<std::uint8_t*>(out));
+	}
+
+	// Writes the bits of <values> to <out>, which must have room for one byte per bit, as bytes of 0 or 1
+	template<typename T, size_t Extent, detail::bit_element U, size_t OutExtent>
+	void unpack_bits(std::span<T, Extent> values, std::span<U, OutExtent> out) {
+		if (out.size() < values.size_bytes() * BITS_PER_BYTE)
+			detail::raise<std::runtime_error>("Range is too small for the bits of the value");
+
+		detail::unpack_bits(std::as_bytes(values).data(), values.size_bytes(), reinterpret_cast<std::uint8_t*>(out.data()));
+	}
+
+	// Sets the bits of <value> from bit_count<T>() bytes starting at <in>, a bit being 1 where its byte is not 0. The bytes are
+	// compared with zero and the results gathered into bits with a movemask, 32 or 64 at a time
+	template<detail::bit_element U, detail::single_object T>
+	void pack_bits(const U* in, T& value) noexcept {
+		detail::pack_bits(reinterpret_cast<const std::uint8_t*>(in), reinterpret_cast<std::byte*>(&value), sizeof(T));
+	}
+
+	// Sets the bits of <values> from <in>, which must have one byte per bit, a bit being 1 where its byte is not 0
+	template<detail::bit_element U, size_t InExtent, typename T, size_t Extent>
+	void pack_bits(std::span<U, InExtent> in, std::span<T, Extent> values) {
+		if (in.size() < values.size_bytes() * BITS_PER_BYTE)
+			detail::raise<std::runtime_error>("Range is too small for the bits of the value");
+
+		detail::pack_bits(reinterpret_cast<const std::uint8_t*>(in.data()), std::as_writable_bytes(values).data(), values.size_bytes());
+	}
+
+	// Inverts (bitwise NOT) all bits in <value>
+	template<typename T>
+	constexpr void invert_bits(T& value) {
+		if constexpr (detail::natively_assignable<T>)
+			value = std::bit_cast<T>(static_cast<detail::native_word_t<T>>(~std::bit_cast<detail::native_word_t<T>>(value)));
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::invert_scalar(bytes.data(), bytes.size());
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			detail::invert(reinterpret_cast<std::byte*>(&value), sizeof(T));
+		}
+	}
+
+	// Inverts (bitwise NOT) all bits in <values>
+	template<typename T, size_t Extent>
+	void invert_bits(std::span<T, Extent> values) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::invert(bytes.data(), bytes.size());
+	}
+
+	// Sets <destination> to the bitwise AND of itself and <source>
+	template<detail::single_object T>
+	constexpr void and_bits(T& destination, const T& source) {
+		detail::combine<detail::and_op>(destination, source, destination);
+	}
+
+	// Writes the bitwise AND of <first> and <second> to <result>
+	template<detail::single_object T>
+	constexpr void and_bits(const T& first, const T& second, T& result) {
+		detail::combine<detail::and_op>(first, second, result);
+	}
+
+	// Sets <destination> to the bitwise AND of itself and <source>, which must have the same size in bytes
+	template<typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void and_bits(std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::and_op>(std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Writes the bitwise AND of <first> and <second> to <result>; all three must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent, typename V, size_t ResultExtent>
+	void and_bits(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second, std::span<V, ResultExtent> result) {
+		detail::combine<detail::and_op>(std::as_bytes(first), std::as_bytes(second), std::as_writable_bytes(result));
+	}
+
+	// Returns the number of bits set to 1 in the bitwise AND of <first> and <second>, without materializing the result
+	template<detail::single_object T>
+	constexpr size_t and_bit_count(const T& first, const T& second) {
+		return detail::combine_popcount<detail::and_op>(first, second);
+	}
+
+	// Returns the number of bits set to 1 in the bitwise AND of <first> and <second>, which must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent>
+	size_t and_bit_count(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second) {
+		return detail::combine_popcount<detail::and_op>(std::as_bytes(first), std::as_bytes(second));
+	}
+
+	// Sets <destination> to the bitwise OR of itself and <source>
+	template<detail::single_object T>
+	constexpr void or_bits(T& destination, const T& source) {
+		detail::combine<detail::or_op>(destination, source, destination);
+	}
+
+	// Writes the bitwise OR of <first> and <second> to <result>
+	template<detail::single_object T>
+	constexpr void or_bits(const T& first, const T& second, T& result) {
+		detail::combine<detail::or_op>(first, second, result);
+	}
+
+	// Sets <destination> to the bitwise OR of itself and <source>, which must have the same size in bytes
+	template<typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void or_bits(std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::or_op>(std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Writes the bitwise OR of <first> and <second> to <result>; all three must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent, typename V, size_t ResultExtent>
+	void or_bits(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second, std::span<V, ResultExtent> result) {
+		detail::combine<detail::or_op>(std::as_bytes(first), std::as_bytes(second), std::as_writable_bytes(result));
+	}
+
+	// Returns the number of bits set to 1 in the bitwise OR of <first> and <second>, without materializing the result
+	template<detail::single_object T>
+	constexpr size_t or_bit_count(const T& first, const T& second) {
+		return detail::combine_popcount<detail::or_op>(first, second);
+	}
+
+	// Returns the number of bits set to 1 in the bitwise OR of <first> and <second>, which must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent>
+	size_t or_bit_count(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second) {
+		return detail::combine_popcount<detail::or_op>(std::as_bytes(first), std::as_bytes(second));
+	}
+
+	// Sets <destination> to the bitwise XOR of itself and <source>
+	template<detail::single_object T>
+	constexpr void xor_bits(T& destination, const T& source) {
+		detail::combine<detail::xor_op>(destination, source, destination);
+	}
+
+	// Writes the bitwise XOR of <first> and <second> to <result>
+	template<detail::single_object T>
+	constexpr void xor_bits(const T& first, const T& second, T& result) {
+		detail::combine<detail::xor_op>(first, second, result);
+	}
+
+	// Sets <destination> to the bitwise XOR of itself and <source>, which must have the same size in bytes
+	template<typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void xor_bits(std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::xor_op>(std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Writes the bitwise XOR of <first> and <second> to <result>; all three must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent, typename V, size_t ResultExtent>
+	void xor_bits(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second, std::span<V, ResultExtent> result) {
+		detail::combine<detail::xor_op>(std::as_bytes(first), std::as_bytes(second), std::as_writable_bytes(result));
+	}
+
+	// Returns the number of bits set to 1 in the bitwise XOR of <first> and <second>, without materializing the result
+	template<detail::single_object T>
+	constexpr size_t xor_bit_count(const T& first, const T& second) {
+		return detail::combine_popcount<detail::xor_op>(first, second);
+	}
+
+	// Returns the number of bits set to 1 in the bitwise XOR of <first> and <second>, which must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent>
+	size_t xor_bit_count(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second) {
+		return detail::combine_popcount<detail::xor_op>(std::as_bytes(first), std::as_bytes(second));
+	}
+
+	// Clears the bits of <destination> that are set in <source>
+	template<detail::single_object T>
+	constexpr void andnot_bits(T& destination, const T& source) {
+		detail::combine<detail::andnot_op>(destination, source, destination);
+	}
+
+	// Writes <first> with the bits set in <second> cleared to <result>
+	template<detail::single_object T>
+	constexpr void andnot_bits(const T& first, const T& second, T& result) {
+		detail::combine<detail::andnot_op>(first, second, result);
+	}
+
+	// Clears the bits of <destination> that are set in <source>, which must have the same size in bytes
+	template<typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void andnot_bits(std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::andnot_op>(std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Writes <first> with the bits set in <second> cleared to <result>; all three must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent, typename V, size_t ResultExtent>
+	void andnot_bits(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second, std::span<V, ResultExtent> result) {
+		detail::combine<detail::andnot_op>(std::as_bytes(first), std::as_bytes(second), std::as_writable_bytes(result));
+	}
+
+	// Returns the number of bits set to 1 in <first> and not in <second>, without materializing the result
+	template<detail::single_object T>
+	constexpr size_t andnot_bit_count(const T& first, const T& second) {
+		return detail::combine_popcount<detail::andnot_op>(first, second);
+	}
+
+	// Returns the number of bits set to 1 in <first> and not in <second>, which must have the same size in bytes
+	template<typename T, size_t FirstExtent, typename U, size_t SecondExtent>
+	size_t andnot_bit_count(std::span<T, FirstExtent> first, std::span<U, SecondExtent> second) {
+		return detail::combine_popcount<detail::andnot_op>(std::as_bytes(first), std::as_bytes(second));
+	}
+
+	// Return the number of bits set to 1 in <value>
+	template<typename T>
+	constexpr size_t one_bit_count(const T& value) {
+		if constexpr (detail::natively_sized<T>)
+			return detail::popcount_native(std::bit_cast<detail::native_word_t<T>>(value));
+		else {
+			if constexpr (detail::bit_castable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					return detail::popcount_scalar(bytes.data(), bytes.size());
+				}
+			}
+			return detail::popcount(reinterpret_cast<const std::byte*>(&value), sizeof(T));
+		}
+	}
+
+	// Return the number of bits set to 1 in <values>
+	template<typename T, size_t Extent>
+	size_t one_bit_count(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::popcount(bytes.data(), bytes.size());
+	}
+
+	// Return the number of bits set to 0 in <value>
+	template<typename T>
+	constexpr size_t zero_bit_count(const T& value) {
+		return bit_count<T>() - one_bit_count(value);
+	}
+
+	// Return the number of bits set to 0 in <values>
+	template<typename T, size_t Extent>
+	size_t zero_bit_count(std::span<T, Extent> values) {
+		return values.size_bytes() * BITS_PER_BYTE - one_bit_count(values);
+	}
+
+	// Returns the number of bits set to 1 among the bits [from, to) of <value>
+	template<detail::single_object T>
+	constexpr size_t one_bit_count(const T& value, size_t from, size_t to) {
+		detail::validate_bit_range(sizeof(T), from, to);
+		if constexpr (detail::natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t))
+			return static_cast<size_t>(std::popcount(static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value)) & detail::range_mask(from, to)));
+		else {
+			if constexpr (detail::bit_castable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					return detail::popcount_range(bytes.data(), bytes.size(), from, to);
+				}
+			}
+			return detail::popcount_range(reinterpret_cast<const std::byte*>(&value), sizeof(T), from, to);
+		}
+	}
+
+	// Returns the number of bits set to 1 among the bits [from, to) of <values>, counting the whole words of the range with the SIMD kernels
+	template<typename T, size_t Extent>
+	size_t one_bit_count(std::span<T, Extent> values, size_t from, size_t to) {
+		auto bytes = std::as_bytes(values);
+		detail::validate_bit_range(bytes.size(), from, to);
+		return detail::popcount_range(bytes.data(), bytes.size(), from, to);
+	}
+
+	// Returns the number of bits set to 0 among the bits [from, to) of <value>
+	template<detail::single_object T>
+	constexpr size_t zero_bit_count(const T& value, size_t from, size_t to) {
+		return to - from - one_bit_count(value, from, to);
+	}
+
+	// Returns the number of bits set to 0 among the bits [from, to) of <values>
+	template<typename T, size_t Extent>
+	size_t zero_bit_count(std::span<T, Extent> values, size_t from, size_t to) {
+		return to - from - one_bit_count(values, from, to);
+	}
+
+	// Returns true if <value> has exactly one bit set to 1, indicating it is a power of two
+	template<typename T>
+	constexpr bool is_power_of_two(const T& value) {
+		if constexpr (detail::natively_sized<T>)
+			return detail::popcount_native(std::bit_cast<detail::native_word_t<T>>(value)) == 1;
+		else {
+			if constexpr (detail::bit_castable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					return detail::is_power_of_two(bytes.data(), bytes.size());
+				}
+			}
+			return detail::is_power_of_two(reinterpret_cast<const std::byte*>(&value), sizeof(T));
+		}
+	}
+
+	// Returns true if <values> have exactly one bit set to 1 in total
+	template<typename T, size_t Extent>
+	bool is_power_of_two(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::is_power_of_two(bytes.data(), bytes.size());
+	}
+
+	// Restores a value of type <T> from a sequence of bytes in the range [first, last)
+	template <typename T, typename InputIt>
+	T restore_value(InputIt first, InputIt last) {
+#ifdef IMD_UNCHECKED
+		assert(detail::enough_bytes<T>(first, last) && "Not enough bytes to restore value");
+#else
+		if (!detail::enough_bytes<T>(first, last))
+			detail::raise<std::runtime_error>("Not enough bytes to restore value");
+#endif
+
+		return detail::restore_value_unchecked<T>(first);
+	}
+
+	// Restores a value of type <T> from a sequence of bytes in the range [first, last), which must have at least sizeof(T) bytes.
+	// Nothing is checked except by a debug assertion
+	template <typename T, typename InputIt>
+	T restore_value_unchecked(InputIt first, [[maybe_unused]] InputIt last) {
+		assert(detail::enough_bytes<T>(first, last) && "Not enough bytes to restore value");
+		return detail::restore_value_unchecked<T>(first);
+	}
+
+	// Restores <value> from a sequence of bytes in the range [first, last) and returns std::errc{}, or returns
+	// std::errc::invalid_argument without changing <value> if there are fewer than sizeof(T) bytes
+	template <typename T, typename InputIt>
+	std::errc try_restore_value(InputIt first, InputIt last, T& value) {
+		if (!detail::enough_bytes<T>(first, last))
+			return std::errc::invalid_argument;
+
+		value = detail::restore_value_unchecked<T>(first);
+		return std::errc{};
+	}
+
+#ifdef __cpp_lib_expected
+	// Restores a value of type <T> from a sequence of bytes in the range [first, last), or returns std::errc::invalid_argument
+	// as the error if there are fewer than sizeof(T) bytes
+	template <typename T, typename InputIt>
+	std::expected<T, std::errc> try_restore_value(InputIt first, InputIt last) {
+		if (!detail::enough_bytes<T>(first, last))
+			return std::unexpected{ std::errc::invalid_argument };
+
+		return detail::restore_value_unchecked<T>(first);
+	}
+#endif
+
+	// Restores every element of <values> from the first values.size() * sizeof(T) bytes of <bytes> with a single copy
+	template<typename T, size_t Extent>
+		requires std::is_trivially_copyable_v<T>
+	void restore_values(std::span<const std::byte> bytes, std::span<T, Extent> values) {
+		if (bytes.size() < values.size_bytes())
+			detail::raise<std::runtime_error>("Not enough bytes to restore value");
+
+		if (!values.empty())
+			std::memcpy(values.data(), bytes.data(), values.size_bytes());
+	}
+
+	// Reverses the byte order of a value of type <T> in place
+	template<typename T>
+	constexpr void byte_swap(T& value) {
+		if constexpr (detail::natively_assignable<T>)
+			value = std::bit_cast<T>(detail::byteswap(std::bit_cast<detail::native_word_t<T>>(value)));
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::reverse_scalar(bytes.data(), bytes.size());
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			detail::reverse(reinterpret_cast<std::byte*>(&value), sizeof(T));
+		}
+	}
+
+	// Reverses the byte order of <values> in place, treating them as one sequence of bytes
+	template<typename T, size_t Extent>
+	void byte_swap(std::span<T, Extent> values) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::reverse(bytes.data(), bytes.size());
+	}
+
+	// Reverses the bytes of each field of <fields> in <value> in place
+	template<typename T>
+	void byte_swap_fields(T& value, std::span<const field> fields) {
+		detail::byte_swap_fields(reinterpret_cast<std::byte*>(&value), 1, sizeof(T), fields);
+	}
+
+	// Reverses the bytes of each field of <fields> in every element of <values> in place
+	template<typename T, size_t Extent>
+	void byte_swap_fields(std::span<T, Extent> values, std::span<const field> fields) {
+		detail::byte_swap_fields(reinterpret_cast<std::byte*>(values.data()), values.size(), sizeof(T), fields);
+	}
+
+	// Converts <value> from the host byte order to big-endian; does nothing on a big-endian host
+	template<typename T>
+	constexpr T to_big_endian(T value) {
+		if constexpr (std::endian::native != std::endian::big)
+			byte_swap(value);
+		return value;
+	}
+
+	// Converts every element of <values> from the host byte order to big-endian in place; does nothing on a big-endian host
+	template<typename T, size_t Extent>
+	void to_big_endian(std::span<T, Extent> values) {
+		if constexpr (std::endian::native != std::endian::big)
+			detail::byte_swap_elements(reinterpret_cast<std::byte*>(values.data()), values.size(), sizeof(T));
+	}
+
+	// Converts every element of <values> from the host byte order to big-endian in place, swapping each field of <fields> on its own; does nothing on a big-endian host
+	template<typename T, size_t Extent>
+	void to_big_endian(std::span<T, Extent> values, std::span<const field> fields) {
+		if constexpr (std::endian::native != std::endian::big)
+			byte_swap_fields(values, fields);
+	}
+
+	// Converts <value> from the host byte order to little-endian; does nothing on a little-endian host
+	template<typename T>
+	constexpr T to_little_endian(T value) {
+		if constexpr (std::endian::native != std::endian::little)
+			byte_swap(value);
+		return value;
+	}
+
+	// Converts every element of <values> from the host byte order to little-endian in place; does nothing on a little-endian host
+	template<typename T, size_t Extent>
+	void to_little_endian(std::span<T, Extent> values) {
+		if constexpr (std::endian::native != std::endian::little)
+			detail::byte_swap_elements(reinterpret_cast<std::byte*>(values.data()), values.size(), sizeof(T));
+	}
+
+	// Converts every element of <values> from the host byte order to little-endian in place, swapping each field of <fields> on its own; does nothing on a little-endian host
+	template<typename T, size_t Extent>
+	void to_little_endian(std::span<T, Extent> values, std::span<const field> fields) {
+		if constexpr (std::endian::native != std::endian::little)
+			byte_swap_fields(values, fields);
+	}
+
+	// Converts <value> from big-endian to the host byte order; does nothing on a big-endian host
+	template<typename T>
+	constexpr T from_big_endian(T value) {
+		if constexpr (std::endian::native != std::endian::big)
+			byte_swap(value);
+		return value;
+	}
+
+	// Converts every element of <values> from big-endian to the host byte order in place; does nothing on a big-endian host
+	template<typename T, size_t Extent>
+	void from_big_endian(std::span<T, Extent> values) {
+		if constexpr (std::endian::native != std::endian::big)
+			detail::byte_swap_elements(reinterpret_cast<std::byte*>(values.data()), values.size(), sizeof(T));
+	}
+
+	// Converts every element of <values> from big-endian to the host byte order in place, swapping each field of <fields> on its own; does nothing on a big-endian host
+	template<typename T, size_t Extent>
+	void from_big_endian(std::span<T, Extent> values, std::span<const field> fields) {
+		if constexpr (std::endian::native != std::endian::big)
+			byte_swap_fields(values, fields);
+	}
+
+	// Converts <value> from little-endian to the host byte order; does nothing on a little-endian host
+	template<typename T>
+	constexpr T from_little_endian(T value) {
+		if constexpr (std::endian::native != std::endian::little)
+			byte_swap(value);
+		return value;
+	}
+
+	// Converts every element of <values> from little-endian to the host byte order in place; does nothing on a little-endian host
+	template<typename T, size_t Extent>
+	void from_little_endian(std::span<T, Extent> values) {
+		if constexpr (std::endian::native != std::endian::little)
+			detail::byte_swap_elements(reinterpret_cast<std::byte*>(values.data()), values.size(), sizeof(T));
+	}
+
+	// Converts every element of <values> from little-endian to the host byte order in place, swapping each field of <fields> on its own; does nothing on a little-endian host
+	template<typename T, size_t Extent>
+	void from_little_endian(std::span<T, Extent> values, std::span<const field> fields) {
+		if constexpr (std::endian::native != std::endian::little)
+			byte_swap_fields(values, fields);
+	}
+
+	// Shifts the bits of <value> to the left (towards higher bit indices) by <shift> positions
+	template<typename T>
+	constexpr void shift_left_bits(T& value, size_t shift) {
+		if constexpr (detail::natively_assignable<T>) {
+			using word_type = detail::native_word_t<T>;
+			auto word = std::bit_cast<word_type>(value);
+			value = std::bit_cast<T>(shift < bit_count<T>() ? static_cast<word_type>(word << shift) : word_type{ 0 });
+		}
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::shift_left(bytes.data(), bytes.data(), bytes.size(), shift);
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			auto ptr = reinterpret_cast<std::byte*>(&value);
+			detail::shift_left(ptr, ptr, sizeof(T), shift);
+		}
+	}
+
+	// Writes the bits of <source> shifted to the left (towards higher bit indices) by <shift> positions to <destination>
+	template<detail::single_object T>
+	constexpr void shift_left_bits(const T& source, T& destination, size_t shift) {
+		if constexpr (detail::bit_cast_assignable<T>) {
+			if (detail::natively_sized<T> || std::is_constant_evaluated()) {
+				destination = source;
+				shift_left_bits(destination, shift);
+				return;
+			}
+		}
+		detail::shift_left(reinterpret_cast<std::byte*>(&destination), reinterpret_cast<const std::byte*>(&source), sizeof(T), shift);
+	}
+
+	// Shifts the bits of <values> to the left (towards higher bit indices) by <shift> positions, treating them as one sequence of bits
+	template<typename T, size_t Extent>
+	void shift_left_bits(std::span<T, Extent> values, size_t shift) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::shift_left(bytes.data(), bytes.data(), bytes.size(), shift);
+	}
+
+	// Writes the bits of <source> shifted to the left (towards higher bit indices) by <shift> positions to <destination>, which must have
+	// the same size in bytes and must either be <source> itself or not overlap it
+	template<typename T, size_t SourceExtent, typename U, size_t DestinationExtent>
+	void shift_left_bits(std::span<T, SourceExtent> source, std::span<U, DestinationExtent> destination, size_t shift) {
+		auto source_bytes = std::as_bytes(source);
+		auto destination_bytes = std::as_writable_bytes(destination);
+
+		if (source_bytes.size() != destination_bytes.size())
+			detail::raise<std::runtime_error>("Ranges have different sizes");
+
+		detail::shift_left(destination_bytes.data(), source_bytes.data(), source_bytes.size(), shift);
+	}
+
+	// Shifts the bits of <value> to the right (towards lower bit indices) by <shift> positions
+	template<typename T>
+	constexpr void shift_right_bits(T& value, size_t shift) {
+		if constexpr (detail::natively_assignable<T>) {
+			using word_type = detail::native_word_t<T>;
+			auto word = std::bit_cast<word_type>(value);
+			value = std::bit_cast<T>(shift < bit_count<T>() ? static_cast<word_type>(word >> shift) : word_type{ 0 });
+		}
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::shift_right(bytes.data(), bytes.data(), bytes.size(), shift);
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			auto ptr = reinterpret_cast<std::byte*>(&value);
+			detail::shift_right(ptr, ptr, sizeof(T), shift);
+		}
+	}
+
+	// Writes the bits of <source> shifted to the right (towards lower bit indices) by <shift> positions to <destination>
+	template<detail::single_object T>
+	constexpr void shift_right_bits(const T& source, T& destination, size_t shift) {
+		if constexpr (detail::bit_cast_assignable<T>) {
+			if (detail::natively_sized<T> || std::is_constant_evaluated()) {
+				destination = source;
+				shift_right_bits(destination, shift);
+				return;
+			}
+		}
+		detail::shift_right(reinterpret_cast<std::byte*>(&destination), reinterpret_cast<const std::byte*>(&source), sizeof(T), shift);
+	}
+
+	// Shifts the bits of <values> to the right (towards lower bit indices) by <shift> positions, treating them as one sequence of bits
+	template<typename T, size_t Extent>
+	void shift_right_bits(std::span<T, Extent> values, size_t shift) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::shift_right(bytes.data(), bytes.data(), bytes.size(), shift);
+	}
+
+	// Writes the bits of <source> shifted to the right (towards lower bit indices) by <shift> positions to <destination>, which must have
+	// the same size in bytes and must either be <source> itself or not overlap it
+	template<typename T, size_t SourceExtent, typename U, size_t DestinationExtent>
+	void shift_right_bits(std::span<T, SourceExtent> source, std::span<U, DestinationExtent> destination, size_t shift) {
+		auto source_bytes = std::as_bytes(source);
+		auto destination_bytes = std::as_writable_bytes(destination);
+
+		if (source_bytes.size() != destination_bytes.size())
+			detail::raise<std::runtime_error>("Ranges have different sizes");
+
+		detail::shift_right(destination_bytes.data(), source_bytes.data(), source_bytes.size(), shift);
+	}
+
+	// Rotates the bits of <value> to the left (towards higher bit indices) by <shift> positions
+	template<typename T>
+	constexpr void rotate_left_bits(T& value, size_t shift) {
+		if constexpr (detail::natively_assignable<T>)
+			value = std::bit_cast<T>(detail::rotate_left_native(std::bit_cast<detail::native_word_t<T>>(value), shift));
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::rotate_left(bytes.data(), bytes.size(), shift);
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			detail::rotate_left(reinterpret_cast<std::byte*>(&value), sizeof(T), shift);
+		}
+	}
+
+	// Writes the bits of <source> rotated to the left (towards higher bit indices) by <shift> positions to <destination>
+	template<detail::single_object T>
+	constexpr void rotate_left_bits(const T& source, T& destination, size_t shift) {
+		if constexpr (detail::bit_cast_assignable<T>)
+			destination = source;
+		else
+			std::memcpy(&destination, &source, sizeof(T));
+		rotate_left_bits(destination, shift);
+	}
+
+	// Rotates the bits of <values> to the left (towards higher bit indices) by <shift> positions, treating them as one sequence of bits
+	template<typename T, size_t Extent>
+	void rotate_left_bits(std::span<T, Extent> values, size_t shift) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::rotate_left(bytes.data(), bytes.size(), shift);
+	}
+
+	// Rotates the bits of <value> to the right (towards lower bit indices) by <shift> positions
+	template<typename T>
+	constexpr void rotate_right_bits(T& value, size_t shift) {
+		if constexpr (detail::natively_assignable<T>)
+			value = std::bit_cast<T>(detail::rotate_right_native(std::bit_cast<detail::native_word_t<T>>(value), shift));
+		else {
+			if constexpr (detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					detail::rotate_right(bytes.data(), bytes.size(), shift);
+					value = std::bit_cast<T>(bytes);
+					return;
+				}
+			}
+			detail::rotate_right(reinterpret_cast<std::byte*>(&value), sizeof(T), shift);
+		}
+	}
+
+	// Writes the bits of <source> rotated to the right (towards lower bit indices) by <shift> positions to <destination>
+	template<detail::single_object T>
+	constexpr void rotate_right_bits(const T& source, T& destination, size_t shift) {
+		if constexpr (detail::bit_cast_assignable<T>)
+			destination = source;
+		else
+			std::memcpy(&destination, &source, sizeof(T));
+		rotate_right_bits(destination, shift);
+	}
+
+	// Rotates the bits of <values> to the right (towards lower bit indices) by <shift> positions, treating them as one sequence of bits
+	template<typename T, size_t Extent>
+	void rotate_right_bits(std::span<T, Extent> values, size_t shift) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::rotate_right(bytes.data(), bytes.size(), shift);
+	}
+
+	// Returns true if all bits in <value> are set to 1
+	template<typename T>
+	constexpr bool all_bits_one(const T& value){
+		return detail::all_bytes_equal(value, std::byte{ 0xFF });
+	}
+
+	// Returns true if all bits in <values> are set to 1
+	template<typename T, size_t Extent>
+	bool all_bits_one(std::span<T, Extent> values){
+		auto bytes = std::as_bytes(values);
+		return detail::all_bytes_equal(bytes.data(), bytes.size(), std::byte{ 0xFF });
+	}
+
+	// Returns true if all bits in <value> are set to 0
+	template<typename T>
+	constexpr bool all_bits_zero(const T& value){
+		return detail::all_bytes_equal(value, std::byte{ 0x00 });
+	}
+
+	// Returns true if all bits in <values> are set to 0
+	template<typename T, size_t Extent>
+	bool all_bits_zero(std::span<T, Extent> values){
+		auto bytes = std::as_bytes(values);
+		return detail::all_bytes_equal(bytes.data(), bytes.size(), std::byte{ 0x00 });
+	}
+
+	// Returns true if any bit in <value> is set to 1
+	template<typename T>
+	constexpr bool any_bits_one(const T& value){
+		return !all_bits_zero(value);
+	}
+
+	// Returns true if any bit in <values> is set to 1
+	template<typename T, size_t Extent>
+	bool any_bits_one(std::span<T, Extent> values){
+		return !all_bits_zero(values);
+	}
+
+	// Returns true if any bit in <value> is set to 0
+	template<typename T>
+	constexpr bool any_bits_zero(const T& value){
+		return !all_bits_one(value);
+	}
+
+	// Returns true if any bit in <values> is set to 0
+	template<typename T, size_t Extent>
+	bool any_bits_zero(std::span<T, Extent> values){
+		return !all_bits_one(values);
+	}
+
+	// Returns true if all the bits [from, to) of <value> are set to 1
+	template<detail::single_object T>
+	constexpr bool all_bits_one(const T& value, size_t from, size_t to) {
+		detail::validate_bit_range(sizeof(T), from, to);
+		if constexpr (detail::natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t)) {
+			std::uint64_t mask{ detail::range_mask(from, to) };
+			return (static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value)) & mask) == mask;
+		}
+		else {
+			if constexpr (detail::bit_castable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					return detail::all_bits_equal_range(bytes.data(), bytes.size(), from, to, std::byte{ 0xFF });
+				}
+			}
+			return detail::all_bits_equal_range(reinterpret_cast<const std::byte*>(&value), sizeof(T), from, to, std::byte{ 0xFF });
+		}
+	}
+
+	// Returns true if all the bits [from, to) of <values> are set to 1
+	template<typename T, size_t Extent>
+	bool all_bits_one(std::span<T, Extent> values, size_t from, size_t to) {
+		auto bytes = std::as_bytes(values);
+		detail::validate_bit_range(bytes.size(), from, to);
+		return detail::all_bits_equal_range(bytes.data(), bytes.size(), from, to, std::byte{ 0xFF });
+	}
+
+	// Returns true if all the bits [from, to) of <value> are set to 0
+	template<detail::single_object T>
+	constexpr bool all_bits_zero(const T& value, size_t from, size_t to) {
+		detail::validate_bit_range(sizeof(T), from, to);
+		if constexpr (detail::natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t))
+			return (static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value)) & detail::range_mask(from, to)) == 0;
+		else {
+			if constexpr (detail::bit_castable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto bytes = detail::to_byte_array(value);
+					return detail::all_bits_equal_range(bytes.data(), bytes.size(), from, to, std::byte{ 0x00 });
+				}
+			}
+			return detail::all_bits_equal_range(reinterpret_cast<const std::byte*>(&value), sizeof(T), from, to, std::byte{ 0x00 });
+		}
+	}
+
+	// Returns true if all the bits [from, to) of <values> are set to 0
+	template<typename T, size_t Extent>
+	bool all_bits_zero(std::span<T, Extent> values, size_t from, size_t to) {
+		auto bytes = std::as_bytes(values);
+		detail::validate_bit_range(bytes.size(), from, to);
+		return detail::all_bits_equal_range(bytes.data(), bytes.size(), from, to, std::byte{ 0x00 });
+	}
+
+	// Returns true if any of the bits [from, to) of <value> is set to 1
+	template<detail::single_object T>
+	constexpr bool any_bits_one(const T& value, size_t from, size_t to) {
+		return !all_bits_zero(value, from, to);
+	}
+
+	// Returns true if any of the bits [from, to) of <values> is set to 1
+	template<typename T, size_t Extent>
+	bool any_bits_one(std::span<T, Extent> values, size_t from, size_t to) {
+		return !all_bits_zero(values, from, to);
+	}
+
+	// Returns true if any of the bits [from, to) of <value> is set to 0
+	template<detail::single_object T>
+	constexpr bool any_bits_zero(const T& value, size_t from, size_t to) {
+		return !all_bits_one(value, from, to);
+	}
+
+	// Returns true if any of the bits [from, to) of <values> is set to 0
+	template<typename T, size_t Extent>
+	bool any_bits_zero(std::span<T, Extent> values, size_t from, size_t to) {
+		return !all_bits_one(values, from, to);
+	}
+
+	// Returns the index of the lowest bit of <value> that is set to 1, or npos if there is none
+	template<typename T>
+	constexpr size_t find_first_set(const T& value) {
+		return detail::find_next<false>(value, 0);
+	}
+
+	// Returns the index of the lowest bit of <values> that is set to 1, or npos if there is none
+	template<typename T, size_t Extent>
+	size_t find_first_set(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_next<false>(bytes.data(), bytes.size(), 0);
+	}
+
+	// Returns the index of the highest bit of <value> that is set to 1, or npos if there is none
+	template<typename T>
+	constexpr size_t find_last_set(const T& value) {
+		return detail::find_last<false>(value);
+	}
+
+	// Returns the index of the highest bit of <values> that is set to 1, or npos if there is none
+	template<typename T, size_t Extent>
+	size_t find_last_set(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_prev<false>(bytes.data(), bytes.size(), bytes.size() * BITS_PER_BYTE);
+	}
+
+	// Returns the index of the lowest bit of <value> at or after <from> that is set to 1, or npos if there is none
+	template<typename T>
+	constexpr size_t find_next_set(const T& value, size_t from) {
+		return detail::find_next<false>(value, from);
+	}
+
+	// Returns the index of the lowest bit of <values> at or after <from> that is set to 1, or npos if there is none
+	template<typename T, size_t Extent>
+	size_t find_next_set(std::span<T, Extent> values, size_t from) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_next<false>(bytes.data(), bytes.size(), from);
+	}
+
+	// Returns the index of the lowest bit of <value> that is set to 0, or npos if there is none
+	template<typename T>
+	constexpr size_t find_first_zero(const T& value) {
+		return detail::find_next<true>(value, 0);
+	}
+
+	// Returns the index of the lowest bit of <values> that is set to 0, or npos if there is none
+	template<typename T, size_t Extent>
+	size_t find_first_zero(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_next<true>(bytes.data(), bytes.size(), 0);
+	}
+
+	// Returns the index of the highest bit of <value> that is set to 0, or npos if there is none
+	template<typename T>
+	constexpr size_t find_last_zero(const T& value) {
+		return detail::find_last<true>(value);
+	}
+
+	// Returns the index of the highest bit of <values> that is set to 0, or npos if there is none
+	template<typename T, size_t Extent>
+	size_t find_last_zero(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_prev<true>(bytes.data(), bytes.size(), bytes.size() * BITS_PER_BYTE);
+	}
+
+	// Returns the index of the lowest bit of <value> at or after <from> that is set to 0, or npos if there is none
+	template<typename T>
+	constexpr size_t find_next_zero(const T& value, size_t from) {
+		return detail::find_next<true>(value, from);
+	}
+
+	// Returns the index of the lowest bit of <values> at or after <from> that is set to 0, or npos if there is none
+	template<typename T, size_t Extent>
+	size_t find_next_zero(std::span<T, Extent> values, size_t from) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_next<true>(bytes.data(), bytes.size(), from);
+	}
+
+	// Returns the number of consecutive bits set to 0 in <value>, starting from the lowest bit
+	template<typename T>
+	constexpr size_t countr_zero(const T& value) {
+		size_t index = detail::find_next<false>(value, 0);
+		return index == npos ? sizeof(T) * BITS_PER_BYTE : index;
+	}
+
+	// Returns the number of consecutive bits set to 0 in <values>, starting from the lowest bit
+	template<typename T, size_t Extent>
+	size_t countr_zero(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		size_t index = detail::find_next<false>(bytes.data(), bytes.size(), 0);
+		return index == npos ? bytes.size() * BITS_PER_BYTE : index;
+	}
+
+	// Returns the number of consecutive bits set to 1 in <value>, starting from the lowest bit
+	template<typename T>
+	constexpr size_t countr_one(const T& value) {
+		size_t index = detail::find_next<true>(value, 0);
+		return index == npos ? sizeof(T) * BITS_PER_BYTE : index;
+	}
+
+	// Returns the number of consecutive bits set to 1 in <values>, starting from the lowest bit
+	template<typename T, size_t Extent>
+	size_t countr_one(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		size_t index = detail::find_next<true>(bytes.data(), bytes.size(), 0);
+		return index == npos ? bytes.size() * BITS_PER_BYTE : index;
+	}
+
+	// Returns the number of consecutive bits set to 0 in <value>, starting from the highest bit
+	template<typename T>
+	constexpr size_t countl_zero(const T& value) {
+		size_t index = detail::find_last<false>(value);
+		return index == npos ? sizeof(T) * BITS_PER_BYTE : sizeof(T) * BITS_PER_BYTE - 1 - index;
+	}
+
+	// Returns the number of consecutive bits set to 0 in <values>, starting from the highest bit
+	template<typename T, size_t Extent>
+	size_t countl_zero(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		size_t index = detail::find_prev<false>(bytes.data(), bytes.size(), bytes.size() * BITS_PER_BYTE);
+		return index == npos ? bytes.size() * BITS_PER_BYTE : bytes.size() * BITS_PER_BYTE - 1 - index;
+	}
+
+	// Returns the number of consecutive bits set to 1 in <value>, starting from the highest bit
+	template<typename T>
+	constexpr size_t countl_one(const T& value) {
+		size_t index = detail::find_last<true>(value);
+		return index == npos ? sizeof(T) * BITS_PER_BYTE : sizeof(T) * BITS_PER_BYTE - 1 - index;
+	}
+
+	// Returns the number of consecutive bits set to 1 in <values>, starting from the highest bit
+	template<typename T, size_t Extent>
+	size_t countl_one(std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		size_t index = detail::find_prev<true>(bytes.data(), bytes.size(), bytes.size() * BITS_PER_BYTE);
+		return index == npos ? bytes.size() * BITS_PER_BYTE : bytes.size() * BITS_PER_BYTE - 1 - index;
+	}
+
+	// Calls <f> with the index of every bit of <value> that is set to 1, from the lowest. The work is proportional to the number
+	// of bits set to 1 rather than to the size of <value>. If <f> returns bool, returning false stops the iteration
+	template<typename T, typename F>
+	constexpr void for_each_set_bit(const T& value, F f) {
+		if constexpr (detail::bit_castable<T>) {
+			if (std::is_constant_evaluated()) {
+				auto bytes = detail::to_byte_array(value);
+				detail::for_each_set_bit(bytes.data(), bytes.size(), f);
+				return;
+			}
+		}
+		detail::for_each_set_bit(reinterpret_cast<const std::byte*>(&value), sizeof(T), f);
+	}
+
+	// Calls <f> with the index of every bit of <values> that is set to 1, from the lowest. If <f> returns bool, returning false stops the iteration
+	template<typename T, size_t Extent, typename F>
+	void for_each_set_bit(std::span<T, Extent> values, F f) {
+		auto bytes = std::as_bytes(values);
+		detail::for_each_set_bit(bytes.data(), bytes.size(), f);
+	}
+
+	// Writes the index of every bit of <value> that is set to 1 to <out>, from the lowest, and returns how many it wrote.
+	// <out> must have room for one_bit_count(value) indices
+	template<detail::single_object T>
+	size_t decode_set_bits(const T& value, std::uint32_t* out) {
+		detail::validate_decode_size(sizeof(T));
+		return detail::decode_set_bits(reinterpret_cast<const std::byte*>(&value), sizeof(T), out);
+	}
+
+	// Writes the index of every bit of <values> that is set to 1 to <out>, from the lowest, and returns how many it wrote.
+	// <out> must have room for one_bit_count(values) indices, and <values> can have at most 2^32 bits
+	template<typename T, size_t Extent>
+	size_t decode_set_bits(std::span<T, Extent> values, std::uint32_t* out) {
+		auto bytes = std::as_bytes(values);
+		detail::validate_decode_size(bytes.size());
+		return detail::decode_set_bits(bytes.data(), bytes.size(), out);
+	}
+
+	// Gathers the bits of <value> selected by the bits set in <mask> into the lowest bits of <result>, in order, and clears the rest
+	// of <result>, like PEXT over objects of any size. Returns the number of bits gathered, which <result> must have room for
+	template<detail::single_object T, detail::single_object U>
+	constexpr size_t extract_bits(const T& value, const T& mask, U& result) {
+		if constexpr (detail::natively_sized<T> && sizeof(T) <= sizeof(std::uint64_t) && detail::natively_assignable<U> && sizeof(U) <= sizeof(std::uint64_t)) {
+			auto mask_word = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(mask));
+			auto count = static_cast<size_t>(std::popcount(mask_word));
+			if (count > bit_count<U>())
+				detail::raise<std::runtime_error>("Result is too small for the extracted bits");
+
+			auto word = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(value));
+			word = std::is_constant_evaluated() ? detail::extract_word_scalar(word, mask_word) : detail::extract_word(word, mask_word);
+			result = std::bit_cast<U>(static_cast<detail::native_word_t<U>>(word));
+			return count;
+		}
+		else {
+			if constexpr (detail::bit_castable<T> && detail::bit_cast_assignable<U>) {
+				if (std::is_constant_evaluated()) {
+					auto value_bytes = detail::to_byte_array(value);
+					auto mask_bytes = detail::to_byte_array(mask);
+					std::array<std::byte, sizeof(U)> result_bytes{};
+					size_t count{ detail::popcount_scalar(mask_bytes.data(), mask_bytes.size()) };
+					if (count > bit_count<U>())
+						detail::raise<std::runtime_error>("Result is too small for the extracted bits");
+
+					detail::extract_bits_scalar(value_bytes.data(), mask_bytes.data(), sizeof(T), result_bytes.data(), sizeof(U));
+					result = std::bit_cast<U>(result_bytes);
+					return count;
+				}
+			}
+			return detail::extract_bits({ reinterpret_cast<const std::byte*>(&value), sizeof(T) }, { reinterpret_cast<const std::byte*>(&mask), sizeof(T) },
+				{ reinterpret_cast<std::byte*>(&result), sizeof(U) });
+		}
+	}
+
+	// Returns the bits of <value> selected by the bits set in <mask> gathered into the lowest bits of a 64-bit word, like PEXT over
+	// objects of any size. <mask> can have at most 64 bits set
+	template<detail::single_object T>
+	constexpr std::uint64_t extract_bits(const T& value, const T& mask) {
+		std::uint64_t result{ 0 };
+		extract_bits(value, mask, result);
+		return result;
+	}
+
+	// Gathers the bits of <values> selected by the bits set in <mask>, which must have the same size in bytes, into the lowest bits
+	// of <result> and clears the rest of <result>. Returns the number of bits gathered, which <result> must have room for
+	template<typename T, size_t Extent, typename U, size_t MaskExtent, typename V, size_t ResultExtent>
+	size_t extract_bits(std::span<T, Extent> values, std::span<U, MaskExtent> mask, std::span<V, ResultExtent> result) {
+		return detail::extract_bits(std::as_bytes(values), std::as_bytes(mask), std::as_writable_bytes(result));
+	}
+
+	// Scatters the lowest bits of <source> to the bits of <destination> selected by the bits set in <mask>, in order, and leaves the
+	// other bits of <destination> unchanged, like PDEP over objects of any size. Returns the number of bits scattered, which <source>
+	// must have. <source> must not overlap <destination>
+	template<detail::single_object S, detail::single_object T>
+	constexpr size_t deposit_bits(const S& source, const T& mask, T& destination) {
+		if constexpr (detail::natively_sized<S> && sizeof(S) <= sizeof(std::uint64_t) && detail::natively_assignable<T> && sizeof(T) <= sizeof(std::uint64_t)) {
+			auto mask_word = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(mask));
+			auto count = static_cast<size_t>(std::popcount(mask_word));
+			if (count > bit_count<S>())
+				detail::raise<std::runtime_error>("Source is too small for the deposited bits");
+
+			auto word = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<S>>(source));
+			word = std::is_constant_evaluated() ? detail::deposit_word_scalar(word, mask_word) : detail::deposit_word(word, mask_word);
+			auto kept = static_cast<std::uint64_t>(std::bit_cast<detail::native_word_t<T>>(destination)) & ~mask_word;
+			destination = std::bit_cast<T>(static_cast<detail::native_word_t<T>>(kept | word));
+			return count;
+		}
+		else {
+			if constexpr (detail::bit_castable<S> && detail::bit_cast_assignable<T>) {
+				if (std::is_constant_evaluated()) {
+					auto source_bytes = detail::to_byte_array(source);
+					auto mask_bytes = detail::to_byte_array(mask);
+					auto destination_bytes = detail::to_byte_array(destination);
+					size_t count{ detail::popcount_scalar(mask_bytes.data(), mask_bytes.size()) };
+					if (count > bit_count<S>())
+						detail::raise<std::runtime_error>("Source is too small for the deposited bits");
+
+					detail::deposit_bits_scalar(source_bytes.data(), sizeof(S), mask_bytes.data(), destination_bytes.data(), sizeof(T));
+					destination = std::bit_cast<T>(destination_bytes);
+					return count;
+				}
+			}
+			return detail::deposit_bits({ reinterpret_cast<const std::byte*>(&source), sizeof(S) }, { reinterpret_cast<const std::byte*>(&mask), sizeof(T) },
+				{ reinterpret_cast<std::byte*>(&destination), sizeof(T) });
+		}
+	}
+
+	// Scatters the lowest bits of <source> to the bits of <destination> selected by the bits set in <mask>, which must have the same
+	// size in bytes, and leaves the other bits of <destination> unchanged. Returns the number of bits scattered, which <source> must
+	// have. <source> must not overlap <destination>
+	template<typename S, size_t SourceExtent, typename U, size_t MaskExtent, typename T, size_t DestinationExtent>
+	size_t deposit_bits(std::span<S, SourceExtent> source, std::span<U, MaskExtent> mask, std::span<T, DestinationExtent> destination) {
+		return detail::deposit_bits(std::as_bytes(source), std::as_bytes(mask), std::as_writable_bytes(destination));
+	}
+
+	// Returns the number of bits set to 1 in <values>, counted on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	size_t one_bit_count(const Policy& policy, std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::popcount(policy, bytes.data(), bytes.size());
+	}
+
+	// Returns the number of bits set to 0 in <values>, counted on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	size_t zero_bit_count(const Policy& policy, std::span<T, Extent> values) {
+		return values.size_bytes() * BITS_PER_BYTE - one_bit_count(policy, values);
+	}
+
+	// Returns true if all bits of <values> are set to 1, checked on the threads of <policy>, which stop once one finds a 0
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	bool all_bits_one(const Policy& policy, std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::all_bytes_equal(policy, bytes.data(), bytes.size(), std::byte{ 0xFF });
+	}
+
+	// Returns true if all bits of <values> are set to 0, checked on the threads of <policy>, which stop once one finds a 1
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	bool all_bits_zero(const Policy& policy, std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::all_bytes_equal(policy, bytes.data(), bytes.size(), std::byte{ 0x00 });
+	}
+
+	// Returns true if any bit of <values> is set to 1, checked on the threads of <policy>, which stop once one finds it
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	bool any_bits_one(const Policy& policy, std::span<T, Extent> values) {
+		return !all_bits_zero(policy, values);
+	}
+
+	// Returns true if any bit of <values> is set to 0, checked on the threads of <policy>, which stop once one finds it
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	bool any_bits_zero(const Policy& policy, std::span<T, Extent> values) {
+		return !all_bits_one(policy, values);
+	}
+
+	// Returns the index of the lowest bit of <values> set to 1, or npos if there is none, searched on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	size_t find_first_set(const Policy& policy, std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_first<false>(policy, bytes.data(), bytes.size());
+	}
+
+	// Returns the index of the lowest bit of <values> set to 0, or npos if there is none, searched on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	size_t find_first_zero(const Policy& policy, std::span<T, Extent> values) {
+		auto bytes = std::as_bytes(values);
+		return detail::find_first<true>(policy, bytes.data(), bytes.size());
+	}
+
+	// Inverts all bits of <values> on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t Extent>
+	void invert_bits(const Policy& policy, std::span<T, Extent> values) {
+		auto bytes = std::as_writable_bytes(values);
+		detail::invert(policy, bytes.data(), bytes.size());
+	}
+
+	// Sets <destination> to the bitwise AND of itself and <source>, which must have the same size in bytes, on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void and_bits(const Policy& policy, std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::and_op>(policy, std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Sets <destination> to the bitwise OR of itself and <source>, which must have the same size in bytes, on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void or_bits(const Policy& policy, std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::or_op>(policy, std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Sets <destination> to the bitwise XOR of itself and <source>, which must have the same size in bytes, on the threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void xor_bits(const Policy& policy, std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::xor_op>(policy, std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Sets <destination> to the bitwise AND of itself and the inverse of <source>, which must have the same size in bytes, on the
+	// threads of <policy>
+	template<detail::execution_policy Policy, typename T, size_t DestinationExtent, typename U, size_t SourceExtent>
+	void andnot_bits(const Policy& policy, std::span<T, DestinationExtent> destination, std::span<U, SourceExtent> source) {
+		detail::combine<detail::andnot_op>(policy, std::as_bytes(destination), std::as_bytes(source), std::as_writable_bytes(destination));
+	}
+
+	// Reads consecutive values of type <T> from a sequence of bytes it does not own, such as a buffer of fixed-size records read
+	// from a file or the network. Nothing is copied up front: each value is loaded from the bytes with one memcpy when it is read,
+	// and converted from the byte order <Order> to the host byte order if they differ. Bytes after the last whole record are
+	// left unread and returned by remainder(). The bytes must outlive the reader
+	template<typename T, std::endian Order = std::endian::native>
+		requires std::is_trivially_copyable_v<T>
+	class record_reader {
+	public:
+		// Iterates over the records from the first to the last, yielding each by value
+		class iterator {
+		public:
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			T operator*() const noexcept {
+				return load(ptr_);
+			}
+
+			iterator& operator++() noexcept {
+				ptr_ += sizeof(T);
+				return *this;
+			}
+
+			iterator operator++(int) noexcept {
+				iterator previous{ *this };
+				ptr_ += sizeof(T);
+				return previous;
+			}
+
+			bool operator==(const iterator&) const = default;
+
+		private:
+			friend class record_reader;
+
+			explicit iterator(const std::byte* ptr) noexcept
+				: ptr_{ ptr } {
+			}
+
+			const std::byte* ptr_{ nullptr };
+		};
+
+		// Reads the records of <bytes>
+		explicit record_reader(std::span<const std::byte> bytes) noexcept
+			: first_{ bytes.data() }, last_{ bytes.data() + bytes.size() / sizeof(T) * sizeof(T) }, end_{ bytes.data() + bytes.size() } {
+		}
+
+		// Returns the number of records left to read
+		size_t size() const noexcept {
+			return static_cast<size_t>(last_ - first_) / sizeof(T);
+		}
+
+		// Returns true if there is no record left to read
+		bool empty() const noexcept {
+			return first_ == last_;
+		}
+
+		// Returns the record <index> places after the next one, which must be less than size()
+		T operator[](size_t index) const noexcept {
+			assert(index < size() && "Record index is outside the bytes");
+			return load(first_ + index * sizeof(T));
+		}
+
+		// Reads the next record into <value> and returns true, or returns false if there is none left
+		bool next(T& value) noexcept {
+			if (first_ == last_)
+				return false;
+
+			value = load(first_);
+			first_ += sizeof(T);
+			return true;
+		}
+
+		// Skips up to <count> records
+		void skip(size_t count) noexcept {
+			first_ += std::min(count, size()) * sizeof(T);
+		}
+
+		// Returns the bytes after the last whole record
+		std::span<const std::byte> remainder() const noexcept {
+			return { last_, end_ };
+		}
+
+		iterator begin() const noexcept {
+			return iterator{ first_ };
+		}
+
+		iterator end() const noexcept {
+			return iterator{ last_ };
+		}
+
+	private:
+		const std::byte* first_;
+		const std::byte* last_;
+		const std::byte* end_;
+
+		// Returns the record at <ptr> in the host byte order
+		static T load(const std::byte* ptr) noexcept {
+			T value{ detail::restore_value_unchecked<T>(ptr) };
+			if constexpr (Order != std::endian::native)
+				byte_swap(value);
+			return value;
+		}
+	};
+
+	// A runtime-sized sequence of bits stored in 64-bit words. Bit <i> is bit <i % 64> of word <i / 64>, which on a little-endian
+	// host is the same numbering as the rest of the library, so the bits of an object adopted with from_value keep their indices.
+	// The bits of the last word above size() are always zero, which lets every operation work on whole words
+	class bit_vector {
+	public:
+		using word_type = std::uint64_t;
+		using value_type = bool;
+
+		// The number of bits in one word
+		static constexpr size_t BITS_PER_WORD{ sizeof(word_type) * BITS_PER_BYTE };
+
+		bit_vector() = default;
+
+		// Creates <size> bits, all set to <value>
+		explicit bit_vector(size_t size, bool value = false)
+			: words_(word_count_for(size), value ? ~word_type{ 0 } : word_type{ 0 }), size_{ size } {
+			clear_tail();
+		}
+
+		// Creates a vector with the bits of <value>, copied a word at a time
+		template<typename T>
+			requires std::is_trivially_copyable_v<T>
+		static bit_vector from_value(const T& value) {
+			return from_bytes(std::as_bytes(std::span{ &value, 1 }));
+		}
+
+		// Creates a vector with the bits of the elements of <values>, copied a word at a time
+		template<typename T, size_t Extent>
+		static bit_vector from_span(std::span<T, Extent> values) {
+			return from_bytes(std::as_bytes(values));
+		}
+
+		// Creates a vector with the bits of <bytes>
+		static bit_vector from_bytes(std::span<const std::byte> bytes) {
+			bit_vector result;
+			result.words_.resize(word_count_for(bytes.size() * BITS_PER_BYTE));
+			result.size_ = bytes.size() * BITS_PER_BYTE;
+			if (!bytes.empty())
+				std::memcpy(result.words_.data(), bytes.data(), bytes.size());
+			return result;
+		}
+
+		// Returns the bits as an object of type <T>, which must have exactly size() bits
+		template<typename T>
+			requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+		T to_value() const {
+			if (size_ != sizeof(T) * BITS_PER_BYTE)
+				detail::raise<std::runtime_error>("Bit vector size does not match the size of the value");
+
+			T value;
+			std::memcpy(&value, words_.data(), sizeof(T));
+			return value;
+		}
+
+		// Returns the number of bits
+		size_t size() const noexcept {
+			return size_;
+		}
+
+		// Returns true if there are no bits
+		bool empty() const noexcept {
+			return size_ == 0;
+		}
+
+		// Returns the words the bits are stored in
+		std::span<const word_type> words() const noexcept {
+			return words_;
+		}
+
+		// Returns the words the bits are stored in. The bits above size() in the last word must be left zero
+		std::span<word_type> words() noexcept {
+			return words_;
+		}
+
+		// Returns the bit at <index> without checking it
+		bool operator[](size_t index) const noexcept {
+			return (words_[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+		}
+
+		// Returns the bit at <index>
+		bool test(size_t index) const {
+			check_index(index);
+			return (*this)[index];
+		}
+
+		// Sets the bit at <index> to <value>
+		bit_vector& set(size_t index, bool value = true) {
+			check_index(index);
+			word_type mask{ word_type{ 1 } << (index % BITS_PER_WORD) };
+			if (value)
+				words_[index / BITS_PER_WORD] |= mask;
+			else
+				words_[index / BITS_PER_WORD] &= ~mask;
+			return *this;
+		}
+
+		// Sets the bit at <index> to 0
+		bit_vector& reset(size_t index) {
+			return set(index, false);
+		}
+
+		// Inverts the bit at <index>
+		bit_vector& flip(size_t index) {
+			check_index(index);
+			words_[index / BITS_PER_WORD] ^= word_type{ 1 } << (index % BITS_PER_WORD);
+			return *this;
+		}
+
+		// Sets all bits to 1
+		bit_vector& set() noexcept {
+			std::fill(words_.begin(), words_.end(), ~word_type{ 0 });
+			clear_tail();
+			return *this;
+		}
+
+		// Sets all bits to 0
+		bit_vector& reset() noexcept {
+			std::fill(words_.begin(), words_.end(), word_type{ 0 });
+			return *this;
+		}
+
+		// Inverts all bits
+		bit_vector& flip() noexcept {
+			detail::invert(bytes(), byte_size());
+			clear_tail();
+			return *this;
+		}
+
+		// Changes the number of bits to <size>; new bits are set to <value>
+		void resize(size_t size, bool value = false) {
+			size_t old_size{ size_ };
+			words_.resize(word_count_for(size), value ? ~word_type{ 0 } : word_type{ 0 });
+			size_ = size;
+
+			if (value && size > old_size && old_size % BITS_PER_WORD != 0) // The bits of the old last word above the old size
+				words_[old_size / BITS_PER_WORD] |= ~word_type{ 0 } << (old_size % BITS_PER_WORD);
+			clear_tail();
+		}
+
+		// Appends a bit set to <value>
+		void push_back(bool value) {
+			if (size_ % BITS_PER_WORD == 0)
+				words_.push_back(0);
+			++size_;
+			if (value)
+				words_.back() |= word_type{ 1 } << ((size_ - 1) % BITS_PER_WORD);
+		}
+
+		// Removes all bits
+		void clear() noexcept {
+			words_.clear();
+			size_ = 0;
+		}
+
+		// Returns the number of bits set to 1
+		size_t count() const noexcept {
+			return detail::popcount(bytes(), byte_size());
+		}
+
+		// Returns the index of the first bit at or after <from> that is set to 1, or npos if there is none
+		size_t find_next_set(size_t from = 0) const noexcept {
+			return detail::find_next<false>(bytes(), byte_size(), std::min(from, size_));
+		}
+
+		// Returns the index of the first bit at or after <from> that is set to 0, or npos if there is none
+		size_t find_next_zero(size_t from = 0) const noexcept {
+			size_t index = detail::find_next<true>(bytes(), byte_size(), std::min(from, size_));
+			return index < size_ ? index : npos;
+		}
+
+		// Returns the index of the last bit that is set to 1, or npos if there is none
+		size_t find_last_set() const noexcept {
+			return detail::find_prev<false>(bytes(), byte_size(), size_);
+		}
+
+		// Returns true if all bits are set to 1, including when there are none
+		bool all() const noexcept {
+			if (size_ % BITS_PER_WORD == 0)
+				return detail::all_bytes_equal(bytes(), byte_size(), std::byte{ 0xFF });
+
+			size_t full{ words_.size() - 1 };
+			return detail::all_bytes_equal(bytes(), full * sizeof(word_type), std::byte{ 0xFF }) && words_[full] == tail_mask();
+		}
+
+		// Returns true if any bit is set to 1
+		bool any() const noexcept {
+			return !none();
+		}
+
+		// Returns true if no bit is set to 1
+		bool none() const noexcept {
+			return detail::all_bytes_equal(bytes(), byte_size(), std::byte{ 0 });
+		}
+
+		// Sets every bit to the bitwise AND of itself and the bit of <other> with the same index; both must have the same size
+		bit_vector& operator&=(const bit_vector& other) {
+			return combine<detail::and_op>(other);
+		}
+
+		// Sets every bit to the bitwise OR of itself and the bit of <other> with the same index; both must have the same size
+		bit_vector& operator|=(const bit_vector& other) {
+			return combine<detail::or_op>(other);
+		}
+
+		// Sets every bit to the bitwise XOR of itself and the bit of <other> with the same index; both must have the same size
+		bit_vector& operator^=(const bit_vector& other) {
+			return combine<detail::xor_op>(other);
+		}
+
+		// Clears the bits that are set in <other>; both must have the same size
+		bit_vector& and_not(const bit_vector& other) {
+			return combine<detail::andnot_op>(other);
+		}
+
+		// Shifts the bits towards higher indices by <shift> positions; the bits shifted past size() are lost
+		bit_vector& operator<<=(size_t shift) noexcept {
+			detail::shift_left(bytes(), bytes(), byte_size(), shift);
+			clear_tail();
+			return *this;
+		}
+
+		// Shifts the bits towards lower indices by <shift> positions, filling the top with zeros
+		bit_vector& operator>>=(size_t shift) noexcept {
+			detail::shift_right(bytes(), bytes(), byte_size(), shift);
+			return *this;
+		}
+
+		friend bit_vector operator&(bit_vector first, const bit_vector& second) {
+			return first &= second;
+		}
+
+		friend bit_vector operator|(bit_vector first, const bit_vector& second) {
+			return first |= second;
+		}
+
+		friend bit_vector operator^(bit_vector first, const bit_vector& second) {
+			return first ^= second;
+		}
+
+		friend bit_vector operator~(bit_vector value) {
+			return value.flip();
+		}
+
+		friend bit_vector operator<<(bit_vector value, size_t shift) {
+			return value <<= shift;
+		}
+
+		friend bit_vector operator>>(bit_vector value, size_t shift) {
+			return value >>= shift;
+		}
+
+		friend bool operator==(const bit_vector& first, const bit_vector& second) noexcept {
+			return first.size_ == second.size_ && first.words_ == second.words_;
+		}
+
+	private:
+		std::vector<word_type> words_;
+		size_t size_{ 0 };
+
+		static size_t word_count_for(size_t size) noexcept {
+			return (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+		}
+
+		std::byte* bytes() noexcept {
+			return reinterpret_cast<std::byte*>(words_.data());
+		}
+
+		const std::byte* bytes() const noexcept {
+			return reinterpret_cast<const std::byte*>(words_.data());
+		}
+
+		size_t byte_size() const noexcept {
+			return words_.size() * sizeof(word_type);
+		}
+
+		// The bits of the last word that are below size()
+		word_type tail_mask() const noexcept {
+			return size_ % BITS_PER_WORD == 0 ? ~word_type{ 0 } : ~(~word_type{ 0 } << (size_ % BITS_PER_WORD));
+		}
+
+		void clear_tail() noexcept {
+			if (!words_.empty())
+				words_.back() &= tail_mask();
+		}
+
+		void check_index(size_t index) const {
+			if (index >= size_)
+				detail::raise<std::runtime_error>("Bit index is outside the size of the bit vector");
+		}
+
+		template<typename Op>
+		bit_vector& combine(const bit_vector& other) {
+			if (size_ != other.size_)
+				detail::raise<std::runtime_error>("Bit vectors have different sizes");
+
+			detail::combine<Op>(bytes(), bytes(), other.bytes(), byte_size());
+			return *this;
+		}
+	};
+
+	// A rank/select index over a sequence of bits it does not own, laid out like poppy (Zhou, Andersen and Kaminsky, 2013).
+	// One 64-bit entry per basic block of 2048 bits holds the number of ones before the block, relative to its 2^32-bit chunk,
+	// and the number of ones in each of its first three 512-bit sub-blocks, which is 3.125% of the size of the bits.
+	// Every 8192nd one is sampled for select. The bits must outlive the index and must not change while it is in use
+	class rank_select {
+	public:
+		// Builds the index over the bits of <bytes>
+		explicit rank_select(std::span<const std::byte> bytes)
+			: rank_select(bytes, bytes.size() * BITS_PER_BYTE) {
+		}
+
+		// Builds the index over the bits of <value>
+		template<detail::single_object T>
+			requires std::is_trivially_copyable_v<T>
+		explicit rank_select(const T& value)
+			: rank_select(std::as_bytes(std::span{ &value, 1 })) {
+		}
+
+		// Builds the index over the bits of the elements of <values>
+		template<typename T, size_t Extent>
+		explicit rank_select(std::span<T, Extent> values)
+			: rank_select(std::as_bytes(values)) {
+		}
+
+		// Builds the index over the bits of <bits>
+		explicit rank_select(const bit_vector& bits)
+			: rank_select(std::as_bytes(bits.words()), bits.size()) {
+		}
+
+		// The index would refer to a temporary
+		template<detail::single_object T>
+		explicit rank_select(const T&& value) = delete;
+
+		// Returns the number of bits the index is built over
+		size_t size() const noexcept {
+			return size_;
+		}
+
+		// Returns the number of bits set to 1
+		size_t count() const noexcept {
+			return ones_;
+		}
+
+		// Returns the number of bits set to 1 before <position>, which may be equal to size()
+		size_t rank(size_t position) const {
+			if (position > size_)
+				detail::raise<std::runtime_error>("Bit index is outside the size of the index");
+
+			size_t block{ position / BLOCK_BITS };
+			std::uint64_t entry{ blocks_[block] };
+			size_t result{ ones_before(block) };
+
+			size_t sub_block{ position % BLOCK_BITS / SUB_BLOCK_BITS };
+			for (size_t i{ 0 }; i < sub_block; ++i)
+				result += sub_block_count(entry, i);
+
+			size_t first{ block * BLOCK_BYTES + sub_block * SUB_BLOCK_BYTES };
+			size_t last{ position / BITS_PER_BYTE };
+			result += detail::popcount(data_ + first, last - first);
+
+			if (position % BITS_PER_BYTE != 0) {
+				auto byte = static_cast<unsigned char>(data_[last]);
+				result += static_cast<size_t>(std::popcount(static_cast<unsigned char>(byte & ((1u << position % BITS_PER_BYTE) - 1))));
+			}
+
+			return result;
+		}
+
+		// Returns the number of bits set to 0 before <position>, which may be equal to size()
+		size_t rank0(size_t position) const {
+			return position - rank(position);
+		}
+
+		// Returns the index of the bit set to 1 with the specified <rank>, counting from 0; <rank> must be less than count()
+		size_t select(size_t rank) const {
+			if (rank >= ones_)
+				detail::raise<std::runtime_error>("There are not that many bits set to 1");
+
+			// The sample says in which block the nearest sampled one before <rank> is, and the next sample bounds the search
+			size_t sample{ rank / SELECT_SAMPLE };
+			size_t low{ static_cast<size_t>(samples_[sample]) };
+			size_t high{ sample + 1 < samples_.size() ? static_cast<size_t>(samples_[sample + 1]) + 1 : blocks_.size() - 1 };
+			while (high - low > 1) {
+				size_t middle{ low + (high - low) / 2 };
+				if (ones_before(middle) <= rank)
+					low = middle;
+				else
+					high = middle;
+			}
+
+			size_t remaining{ rank - ones_before(low) };
+			std::uint64_t entry{ blocks_[low] };
+			size_t sub_block{ 0 };
+			for (; sub_block < 3 && remaining >= sub_block_count(entry, sub_block); ++sub_block)
+				remaining -= sub_block_count(entry, sub_block);
+
+			for (size_t offset{ low * BLOCK_BYTES + sub_block * SUB_BLOCK_BYTES };; offset += sizeof(std::uint64_t)) {
+				std::uint64_t word{ word_at(offset) };
+				size_t ones{ detail::popcount_native(word) };
+				if (remaining < ones)
+					return offset * BITS_PER_BYTE + detail::select_in_word(word, static_cast<unsigned>(remaining));
+				remaining -= ones;
+			}
+		}
+
+		// Returns the size of the index in bytes, not counting the bits themselves
+		size_t index_size() const noexcept {
+			return (chunks_.size() + blocks_.size() + samples_.size()) * sizeof(std::uint64_t);
+		}
+
+	private:
+		static constexpr size_t BLOCK_BITS{ 2048 };
+		static constexpr size_t BLOCK_BYTES{ BLOCK_BITS / BITS_PER_BYTE };
+		static constexpr size_t SUB_BLOCK_BITS{ 512 };
+		static constexpr size_t SUB_BLOCK_BYTES{ SUB_BLOCK_BITS / BITS_PER_BYTE };
+		static constexpr unsigned CHUNK_SHIFT{ 32 };
+		static constexpr size_t SELECT_SAMPLE{ 8192 };
+		static constexpr std::uint64_t RELATIVE_MASK{ 0xFFFFFFFF };
+
+		// Ranges of at least this many bytes are counted on the threads of the shared pool
+		static constexpr size_t PARALLEL_BUILD_THRESHOLD{ 1 << 24 };
+
+		const std::byte* data_;
+		size_t byte_size_;
+		size_t size_;
+		size_t ones_{ 0 };
+		std::vector<std::uint64_t> chunks_;  // The number of ones before each 2^32-bit chunk
+		std::vector<std::uint64_t> blocks_;  // One entry per basic block and one past the last
+		std::vector<std::uint64_t> samples_; // The block of every SELECT_SAMPLE-th one
+
+		// Builds the index over the first <bit_count> bits of <bytes>; any bits of the last byte past them must be 0
+		rank_select(std::span<const std::byte> bytes, size_t bit_count)
+			: data_{ bytes.data() }, byte_size_{ bytes.size() }, size_{ bit_count } {
+			size_t block_count{ (size_ + BLOCK_BITS - 1) / BLOCK_BITS };
+			blocks_.assign(block_count + 1, 0);
+			chunks_.assign((static_cast<std::uint64_t>(block_count * BLOCK_BITS) >> CHUNK_SHIFT) + 1, 0);
+
+			// First the ones of every block on their own, which is independent for each block. Large ranges are counted in chunks taken
+			// by the threads of the pool, smaller ones on the calling thread without starting the pool
+			constexpr size_t blocks_per_chunk{ detail::PARALLEL_CHUNK / BLOCK_BYTES };
+			size_t chunks{ (block_count + blocks_per_chunk - 1) / blocks_per_chunk };
+			if (byte_size_ >= PARALLEL_BUILD_THRESHOLD && chunks > 1) {
+				auto& pool = detail::thread_pool::instance();
+				pool.run(chunks, pool.size(), [&](size_t chunk) {
+					count_blocks(chunk * blocks_per_chunk, std::min(block_count, (chunk + 1) * blocks_per_chunk));
+				});
+			}
+			else
+				count_blocks(0, block_count);
+
+			// Then the running totals and the select samples in a single pass over the entries
+			std::uint64_t total{ 0 };
+			for (size_t block{ 0 }; block <= block_count; ++block) {
+				auto position = static_cast<std::uint64_t>(block * BLOCK_BITS);
+				if (position % (std::uint64_t{ 1 } << CHUNK_SHIFT) == 0)
+					chunks_[position >> CHUNK_SHIFT] = total;
+
+				std::uint64_t ones{ blocks_[block] & RELATIVE_MASK };
+				blocks_[block] = (blocks_[block] & ~RELATIVE_MASK) | (total - chunks_[position >> CHUNK_SHIFT]);
+
+				while (samples_.size() * SELECT_SAMPLE < total + ones)
+					samples_.push_back(block);
+				total += ones;
+			}
+			ones_ = static_cast<size_t>(total);
+		}
+
+		// Stores the number of ones in each of the blocks [<first>, <last>) in the low half of its entry and the counts of its sub-blocks above
+		void count_blocks(size_t first, size_t last) noexcept {
+			for (size_t block{ first }; block < last; ++block) {
+				std::uint64_t entry{ 0 };
+				std::uint64_t total{ 0 };
+				for (size_t i{ 0 }; i < BLOCK_BYTES / SUB_BLOCK_BYTES; ++i) {
+					size_t begin{ std::min(byte_size_, block * BLOCK_BYTES + i * SUB_BLOCK_BYTES) };
+					size_t end{ std::min(byte_size_, begin + SUB_BLOCK_BYTES) };
+					std::uint64_t ones{ detail::popcount(data_ + begin, end - begin) };
+					if (i < 3)
+						entry |= ones << (32 + 10 * i);
+					total += ones;
+				}
+				blocks_[block] = entry | total;
+			}
+		}
+
+		// Returns the number of ones before <block>
+		size_t ones_before(size_t block) const noexcept {
+			return static_cast<size_t>(chunks_[static_cast<std::uint64_t>(block * BLOCK_BITS) >> CHUNK_SHIFT] + (blocks_[block] & RELATIVE_MASK));
+		}
+
+		// Returns the number of ones in the sub-block <index> (0 to 2) of the block with <entry>
+		static size_t sub_block_count(std::uint64_t entry, size_t index) noexcept {
+			return static_cast<size_t>((entry >> (32 + 10 * index)) & 0x3FF);
+		}
+
+		// Returns the 8 bytes starting at <offset>, with zeros past the end of the bits
+		std::uint64_t word_at(size_t offset) const noexcept {
+			if (offset + sizeof(std::uint64_t) <= byte_size_)
+				return detail::load_word(data_ + offset);
+
+			std::array<std::byte, sizeof(std::uint64_t)> bytes{};
+			std::copy(data_ + offset, data_ + byte_size_, bytes.begin());
+			return detail::load_word(bytes.data());
+		}
+	};
+
+#if __has_include(<sys/mman.h>)
+	// A file mapped into memory with mmap, whose bytes every span overload of the library can work on in place, without reading
+	// the file first. A read_write mapping is shared with the file: changes reach it when the mapping is synced or unmapped.
+	// The kernel is told how the bytes will be read with madvise, which for sequential reads doubles its read-ahead
+	class mapped_bytes {
+	public:
+		// Whether the bytes of the mapping can be changed
+		enum class access {
+			read_only,
+			read_write
+		};
+
+		// How the bytes will be read, passed to the kernel as a hint
+		enum class pattern {
+			normal,
+			sequential,
+			random
+		};
+
+		mapped_bytes() = default;
+
+		// Maps the whole file at <path>. With <huge_pages>, transparent huge pages are requested for the mapping, which
+		// needs kernel support for huge pages in the page cache and is ignored without it
+		explicit mapped_bytes(const char* path, access mode = access::read_only, pattern hint = pattern::sequential, bool huge_pages = false) {
+			int fd{ ::open(path, mode == access::read_write ? O_RDWR : O_RDONLY) };
+			if (fd < 0)
+				detail::raise<std::system_error>(errno, std::generic_category(), "Failed to open the file to map");
+
+			struct stat status {};
+			if (::fstat(fd, &status) != 0) {
+				int error{ errno };
+				::close(fd);
+				detail::raise<std::system_error>(error, std::generic_category(), "Failed to get the size of the file to map");
+			}
+
+			size_ = static_cast<size_t>(status.st_size);
+			if (size_ != 0) {
+				int protection{ mode == access::read_write ? PROT_READ | PROT_WRITE : PROT_READ };
+				void* data{ ::mmap(nullptr, size_, protection, MAP_SHARED, fd, 0) };
+				if (data == MAP_FAILED) {
+					int error{ errno };
+					::close(fd);
+					detail::raise<std::system_error>(error, std::generic_category(), "Failed to map the file");
+				}
+				data_ = static_cast<std::byte*>(data);
+			}
+			::close(fd);
+			writable_ = mode == access::read_write;
+
+			advise(hint, huge_pages);
+		}
+
+		// Maps the whole file at <path>
+		explicit mapped_bytes(const std::string& path, access mode = access::read_only, pattern hint = pattern::sequential, bool huge_pages = false)
+			: mapped_bytes(path.c_str(), mode, hint, huge_pages) {
+		}
+
+		mapped_bytes(const mapped_bytes&) = delete;
+		mapped_bytes& operator=(const mapped_bytes&) = delete;
+
+		mapped_bytes(mapped_bytes&& other) noexcept
+			: data_{ std::exchange(other.data_, nullptr) }, size_{ std::exchange(other.size_, 0) }, writable_{ std::exchange(other.writable_, false) } {
+		}
+
+		mapped_bytes& operator=(mapped_bytes&& other) noexcept {
+			if (this != &other) {
+				unmap();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+				writable_ = std::exchange(other.writable_, false);
+			}
+			return *this;
+		}
+
+		// Unmaps the file; the changes of a read_write mapping are written back by the kernel later
+		~mapped_bytes() {
+			unmap();
+		}
+
+		// Returns the number of bytes of the file
+		size_t size() const noexcept {
+			return size_;
+		}
+
+		// Returns true if the file is empty or nothing is mapped
+		bool empty() const noexcept {
+			return size_ == 0;
+		}
+
+		// Returns true if the bytes can be changed
+		bool writable() const noexcept {
+			return writable_;
+		}
+
+		// Returns the bytes of the file
+		std::span<const std::byte> bytes() const noexcept {
+			return { data_, size_ };
+		}
+
+		// Returns the bytes of the file for changing them; the mapping must be read_write
+		std::span<std::byte> writable_bytes() noexcept {
+			assert(writable_ && "The file is mapped read-only");
+			return { data_, size_ };
+		}
+
+		// Returns the bytes of the file as whole values of type <T>; bytes after the last whole value are left out. The
+		// mapping starts at a page boundary, so the values are aligned
+		template<typename T>
+			requires std::is_trivially_copyable_v<T>
+		std::span<const T> as_span() const noexcept {
+			return { reinterpret_cast<const T*>(data_), size_ / sizeof(T) };
+		}
+
+		// Returns the bytes of the file as whole values of type <T> for changing them; the mapping must be read_write
+		template<typename T>
+			requires std::is_trivially_copyable_v<T>
+		std::span<T> as_writable_span() noexcept {
+			assert(writable_ && "The file is mapped read-only");
+			return { reinterpret_cast<T*>(data_), size_ / sizeof(T) };
+		}
+
+		// Writes the changes of the bytes [offset, offset + count) back to the file with msync, waiting for the writes to
+		// finish unless <wait> is false. The range is widened to whole pages
+		void sync(size_t offset, size_t count, bool wait = true) {
+			if (offset > size_ || count > size_ - offset)
+				detail::raise<std::runtime_error>("Range is outside the mapped file");
+			if (count == 0)
+				return;
+
+			auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+			size_t first{ offset / page * page };
+			if (::msync(data_ + first, offset + count - first, wait ? MS_SYNC : MS_ASYNC) != 0)
+				detail::raise<std::system_error>(errno, std::generic_category(), "Failed to write the mapped file back");
+		}
+
+		// Writes the changes of all the bytes back to the file with msync, waiting for the writes to finish unless <wait> is false
+		void sync(bool wait = true) {
+			sync(0, size_, wait);
+		}
+
+	private:
+		std::byte* data_{ nullptr };
+		size_t size_{ 0 };
+		bool writable_{ false };
+
+		void advise(pattern hint, bool huge_pages) noexcept {
+			if (data_ == nullptr)
+				return;
+
+			int advice{ hint == pattern::sequential ? MADV_SEQUENTIAL : hint == pattern::random ? MADV_RANDOM : MADV_NORMAL };
+			::madvise(data_, size_, advice);
+#ifdef MADV_HUGEPAGE
+			if (huge_pages)
+				::madvise(data_, size_, MADV_HUGEPAGE);
+#else
+			(void)huge_pages;
+#endif
+		}
+
+		void unmap() noexcept {
+			if (data_ != nullptr)
+				::munmap(data_, size_);
+			data_ = nullptr;
+			size_ = 0;
+		}
+	};
+#endif
 
 }
 
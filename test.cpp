@@ -0,0 +1,490 @@
+#include "memory_library.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+Compares every runtime-dispatched operation of memory_library.h with a bit-by-bit reference over byte ranges of every length up
+to 1100 bytes around the 32-, 64- and 256-byte boundaries of the SIMD kernels, filled with random, sparse, all-zero and all-one
+bits and with a single differing bit at every position, and over single objects of 1 to 4096 bytes. It prints the kernel each
+operation is bound to, every mismatch, and exits with a non-zero status if there was any.
+
+	test
+
+Run it once as it is and once with IMD_FORCE_SCALAR=1, so that both the widest kernels of the CPU and the scalar ones are checked:
+
+	g++ -std=c++20 -O2 test.cpp -o test && ./test && IMD_FORCE_SCALAR=1 ./test
+*/
+
+using bytes = std::vector<std::uint8_t>;
+
+size_t checks{ 0 };
+size_t failures{ 0 };
+
+// Counts a check and reports it if <passed> is false, with the operation, the length of the range and the pattern of its bits
+void check(bool passed, const char* operation, size_t size, const char* pattern) {
+	++checks;
+	if (!passed && ++failures <= 50)
+		std::printf("FAIL %s over %zu bytes of %s bits\n", operation, size, pattern);
+}
+
+// The bit-by-bit reference the kernels are compared with, following the bit numbering of the library
+namespace reference {
+
+	bool get(const bytes& b, size_t i) {
+		return (b[i / 8] >> (i % 8)) & 1;
+	}
+
+	void set(bytes& b, size_t i, bool bit) {
+		if (bit)
+			b[i / 8] = static_cast<std::uint8_t>(b[i / 8] | (1u << (i % 8)));
+		else
+			b[i / 8] = static_cast<std::uint8_t>(b[i / 8] & ~(1u << (i % 8)));
+	}
+
+	size_t count(const bytes& b, size_t from, size_t to, bool bit) {
+		size_t result{ 0 };
+		for (size_t i{ from }; i < to; ++i)
+			result += get(b, i) == bit;
+		return result;
+	}
+
+	size_t find_next(const bytes& b, size_t from, bool bit) {
+		for (size_t i{ from }; i < b.size() * 8; ++i)
+			if (get(b, i) == bit)
+				return i;
+		return IMD::npos;
+	}
+
+	size_t find_last(const bytes& b, bool bit) {
+		for (size_t i{ b.size() * 8 }; i-- > 0;)
+			if (get(b, i) == bit)
+				return i;
+		return IMD::npos;
+	}
+
+	size_t run_from_low(const bytes& b, bool bit) {
+		size_t i{ 0 };
+		while (i < b.size() * 8 && get(b, i) == bit)
+			++i;
+		return i;
+	}
+
+	size_t run_from_high(const bytes& b, bool bit) {
+		size_t i{ 0 };
+		while (i < b.size() * 8 && get(b, b.size() * 8 - 1 - i) == bit)
+			++i;
+		return i;
+	}
+
+	// Returns <b> shifted towards higher bit indices by <shift> if <left>, else towards lower ones, filling with zeros
+	bytes shift(const bytes& b, size_t shift, bool left) {
+		bytes result(b.size(), 0);
+		size_t n{ b.size() * 8 };
+		for (size_t i{ 0 }; i < n; ++i) {
+			size_t from{ left ? i - shift : i + shift };
+			if (left ? i >= shift : shift < n - i)
+				set(result, i, get(b, from));
+		}
+		return result;
+	}
+
+	bytes rotate(const bytes& b, size_t shift, bool left) {
+		bytes result(b.size(), 0);
+		size_t n{ b.size() * 8 };
+		if (n == 0)
+			return result;
+		for (size_t i{ 0 }; i < n; ++i)
+			set(result, left ? (i + shift) % n : (i + n - shift % n) % n, get(b, i));
+		return result;
+	}
+
+	bytes extract(const bytes& value, const bytes& mask, size_t result_size) {
+		bytes result(result_size, 0);
+		size_t k{ 0 };
+		for (size_t i{ 0 }; i < value.size() * 8; ++i)
+			if (get(mask, i))
+				set(result, k++, get(value, i));
+		return result;
+	}
+
+	bytes deposit(const bytes& source, const bytes& mask, bytes destination) {
+		size_t k{ 0 };
+		for (size_t i{ 0 }; i < mask.size() * 8; ++i)
+			if (get(mask, i))
+				set(destination, i, get(source, k++));
+		return destination;
+	}
+
+}
+
+// The patterns of bits the ranges are filled with
+enum class pattern {
+	random,
+	sparse,
+	zeros,
+	ones
+};
+
+constexpr std::array<const char*, 4> PATTERN_NAMES{ "random", "sparse", "all-zero", "all-one" };
+
+std::mt19937_64 generator{ 2024 };
+
+bytes make(size_t size, pattern kind) {
+	bytes result(size);
+	for (auto& byte : result) {
+		switch (kind) {
+		case pattern::random: byte = static_cast<std::uint8_t>(generator()); break;
+		case pattern::sparse: byte = generator() % 61 == 0 ? static_cast<std::uint8_t>(1u << generator() % 8) : 0; break;
+		case pattern::zeros: byte = 0; break;
+		case pattern::ones: byte = 0xFF; break;
+		}
+	}
+	return result;
+}
+
+// Counts, predicates, searches and runs over <b>, whole and over a few ranges [from, to)
+void check_queries(const bytes& b, const char* name) {
+	std::span<const std::uint8_t> s{ b };
+	size_t n{ b.size() * 8 };
+
+	check(IMD::one_bit_count(s) == reference::count(b, 0, n, true), "one_bit_count", b.size(), name);
+	check(IMD::zero_bit_count(s) == reference::count(b, 0, n, false), "zero_bit_count", b.size(), name);
+	check(IMD::one_bit_count(IMD::par, s) == reference::count(b, 0, n, true), "one_bit_count(par)", b.size(), name);
+	check(IMD::all_bits_one(s) == (reference::count(b, 0, n, false) == 0), "all_bits_one", b.size(), name);
+	check(IMD::all_bits_zero(s) == (reference::count(b, 0, n, true) == 0), "all_bits_zero", b.size(), name);
+	check(IMD::any_bits_one(s) == (reference::count(b, 0, n, true) != 0), "any_bits_one", b.size(), name);
+	check(IMD::any_bits_zero(s) == (reference::count(b, 0, n, false) != 0), "any_bits_zero", b.size(), name);
+	check(IMD::all_bits_zero(IMD::par, s) == (reference::count(b, 0, n, true) == 0), "all_bits_zero(par)", b.size(), name);
+
+	check(IMD::find_first_set(s) == reference::find_next(b, 0, true), "find_first_set", b.size(), name);
+	check(IMD::find_first_zero(s) == reference::find_next(b, 0, false), "find_first_zero", b.size(), name);
+	check(IMD::find_last_set(s) == reference::find_last(b, true), "find_last_set", b.size(), name);
+	check(IMD::find_last_zero(s) == reference::find_last(b, false), "find_last_zero", b.size(), name);
+	check(IMD::find_first_set(IMD::par, s) == reference::find_next(b, 0, true), "find_first_set(par)", b.size(), name);
+	check(IMD::countr_zero(s) == reference::run_from_low(b, false), "countr_zero", b.size(), name);
+	check(IMD::countr_one(s) == reference::run_from_low(b, true), "countr_one", b.size(), name);
+	check(IMD::countl_zero(s) == reference::run_from_high(b, false), "countl_zero", b.size(), name);
+	check(IMD::countl_one(s) == reference::run_from_high(b, true), "countl_one", b.size(), name);
+
+	for (size_t from : { size_t{ 0 }, size_t{ 1 }, size_t{ 63 }, size_t{ 64 }, size_t{ 257 }, n / 2, n }) {
+		if (from > n)
+			continue;
+		check(IMD::find_next_set(s, from) == reference::find_next(b, from, true), "find_next_set", b.size(), name);
+		check(IMD::find_next_zero(s, from) == reference::find_next(b, from, false), "find_next_zero", b.size(), name);
+
+		for (size_t to : { from, from + 1, from + 64, from + 513, n }) {
+			if (to > n)
+				continue;
+			size_t ones{ reference::count(b, from, to, true) };
+			size_t zeros{ to - from - ones };
+			check(IMD::one_bit_count(s, from, to) == ones, "one_bit_count(from, to)", b.size(), name);
+			check(IMD::zero_bit_count(s, from, to) == zeros, "zero_bit_count(from, to)", b.size(), name);
+			check(IMD::all_bits_one(s, from, to) == (zeros == 0), "all_bits_one(from, to)", b.size(), name);
+			check(IMD::all_bits_zero(s, from, to) == (ones == 0), "all_bits_zero(from, to)", b.size(), name);
+			check(IMD::any_bits_one(s, from, to) == (ones != 0), "any_bits_one(from, to)", b.size(), name);
+			check(IMD::any_bits_zero(s, from, to) == (zeros != 0), "any_bits_zero(from, to)", b.size(), name);
+		}
+	}
+
+	std::vector<std::uint32_t> decoded(n + 1);
+	size_t count{ IMD::decode_set_bits(s, decoded.data()) };
+	std::vector<std::uint32_t> expected;
+	for (size_t i{ 0 }; i < n; ++i)
+		if (reference::get(b, i))
+			expected.push_back(static_cast<std::uint32_t>(i));
+	check(count == expected.size() && std::equal(expected.begin(), expected.end(), decoded.begin()), "decode_set_bits", b.size(), name);
+
+	std::vector<std::uint32_t> visited;
+	IMD::for_each_set_bit(s, [&](size_t i) { visited.push_back(static_cast<std::uint32_t>(i)); });
+	check(visited == expected, "for_each_set_bit", b.size(), name);
+
+	if (n != 0) {
+		IMD::rank_select index{ s };
+		bool ranks{ true };
+		for (size_t position : { size_t{ 0 }, size_t{ 1 }, n / 3, n / 2, n - 1, n })
+			ranks &= index.rank(position) == reference::count(b, 0, position, true);
+		check(ranks, "rank_select::rank", b.size(), name);
+
+		bool selects{ true };
+		for (size_t k{ 0 }; k < expected.size(); k += 1 + expected.size() / 16)
+			selects &= index.select(k) == expected[k];
+		check(selects, "rank_select::select", b.size(), name);
+	}
+}
+
+// Combinators, inversion, shifts, rotations, gathers and scatters of <first> and <second>, which have the same size
+void check_transforms(const bytes& first, const bytes& second, const char* name) {
+	size_t size{ first.size() };
+	size_t n{ size * 8 };
+	std::span<const std::uint8_t> a{ first };
+	std::span<const std::uint8_t> b{ second };
+
+	auto combined = [&](auto op) {
+		bytes result(size);
+		for (size_t i{ 0 }; i < size; ++i)
+			result[i] = static_cast<std::uint8_t>(op(first[i], second[i]));
+		return result;
+	};
+	bytes and_expected{ combined([](unsigned x, unsigned y) { return x & y; }) };
+	bytes or_expected{ combined([](unsigned x, unsigned y) { return x | y; }) };
+	bytes xor_expected{ combined([](unsigned x, unsigned y) { return x ^ y; }) };
+	bytes andnot_expected{ combined([](unsigned x, unsigned y) { return x & ~y; }) };
+
+	bytes result(size);
+	IMD::and_bits(a, b, std::span{ result });
+	check(result == and_expected, "and_bits", size, name);
+	IMD::or_bits(a, b, std::span{ result });
+	check(result == or_expected, "or_bits", size, name);
+	IMD::xor_bits(a, b, std::span{ result });
+	check(result == xor_expected, "xor_bits", size, name);
+	IMD::andnot_bits(a, b, std::span{ result });
+	check(result == andnot_expected, "andnot_bits", size, name);
+
+	result = first;
+	IMD::xor_bits(std::span{ result }, b);
+	check(result == xor_expected, "xor_bits(in place)", size, name);
+	result = first;
+	IMD::andnot_bits(IMD::par, std::span{ result }, b);
+	check(result == andnot_expected, "andnot_bits(par)", size, name);
+
+	check(IMD::and_bit_count(a, b) == reference::count(and_expected, 0, n, true), "and_bit_count", size, name);
+	check(IMD::or_bit_count(a, b) == reference::count(or_expected, 0, n, true), "or_bit_count", size, name);
+	check(IMD::xor_bit_count(a, b) == reference::count(xor_expected, 0, n, true), "xor_bit_count", size, name);
+	check(IMD::andnot_bit_count(a, b) == reference::count(andnot_expected, 0, n, true), "andnot_bit_count", size, name);
+
+	result = first;
+	IMD::invert_bits(std::span{ result });
+	check(result == combined([](unsigned x, unsigned) { return ~x; }), "invert_bits", size, name);
+
+	for (size_t shift : { size_t{ 0 }, size_t{ 1 }, size_t{ 7 }, size_t{ 8 }, size_t{ 9 }, size_t{ 63 }, size_t{ 64 }, size_t{ 65 }, size_t{ 255 },
+		size_t{ 256 }, size_t{ 2049 }, n / 2 + 3, n == 0 ? 0 : n - 1, n, n + 5 }) {
+		result = first;
+		IMD::shift_left_bits(std::span{ result }, shift);
+		check(result == reference::shift(first, shift, true), "shift_left_bits", size, name);
+		result = first;
+		IMD::shift_right_bits(std::span{ result }, shift);
+		check(result == reference::shift(first, shift, false), "shift_right_bits", size, name);
+		IMD::shift_left_bits(a, std::span{ result }, shift);
+		check(result == reference::shift(first, shift, true), "shift_left_bits(source, destination)", size, name);
+		IMD::shift_right_bits(a, std::span{ result }, shift);
+		check(result == reference::shift(first, shift, false), "shift_right_bits(source, destination)", size, name);
+		result = first;
+		IMD::rotate_left_bits(std::span{ result }, shift);
+		check(result == reference::rotate(first, shift, true), "rotate_left_bits", size, name);
+		result = first;
+		IMD::rotate_right_bits(std::span{ result }, shift);
+		check(result == reference::rotate(first, shift, false), "rotate_right_bits", size, name);
+	}
+
+	result.assign(size, 0xA5);
+	size_t gathered{ IMD::extract_bits(a, b, std::span{ result }) };
+	check(gathered == reference::count(second, 0, n, true) && result == reference::extract(first, second, size), "extract_bits", size, name);
+	result = second;
+	size_t scattered{ IMD::deposit_bits(a, b, std::span{ result }) };
+	check(scattered == reference::count(second, 0, n, true) && result == reference::deposit(first, second, second), "deposit_bits", size, name);
+}
+
+// Bit fields, edits, unpacking and packing, and conversions of <b>
+void check_edits(const bytes& b, const char* name) {
+	size_t size{ b.size() };
+	size_t n{ size * 8 };
+	bytes result;
+
+	for (size_t offset : { size_t{ 0 }, size_t{ 3 }, size_t{ 60 }, size_t{ 64 }, n / 2 + 1 }) {
+		if (offset > n)
+			continue;
+		for (size_t width : { size_t{ 0 }, size_t{ 1 }, size_t{ 13 }, size_t{ 64 } }) {
+			if (offset + width > n)
+				continue;
+			std::uint64_t expected{ 0 };
+			for (size_t i{ 0 }; i < width; ++i)
+				expected |= std::uint64_t{ reference::get(b, offset + i) } << i;
+			check(IMD::get_bits(std::span{ b }, offset, width) == expected, "get_bits", size, name);
+
+			std::uint64_t bits{ generator() };
+			result = b;
+			IMD::set_bits(std::span{ result }, offset, width, bits);
+			bytes set_expected{ b };
+			for (size_t i{ 0 }; i < width; ++i)
+				reference::set(set_expected, offset + i, (bits >> i) & 1);
+			check(result == set_expected, "set_bits", size, name);
+		}
+
+		for (size_t to : { offset, offset + 1, offset + 100, offset + 700, n }) {
+			if (to > n)
+				continue;
+			for (bool bit : { false, true }) {
+				result = b;
+				IMD::fill_bits(std::span{ result }, offset, to, bit);
+				bytes fill_expected{ b };
+				for (size_t i{ offset }; i < to; ++i)
+					reference::set(fill_expected, i, bit);
+				check(result == fill_expected, "fill_bits", size, name);
+			}
+		}
+	}
+
+	if (n != 0) {
+		// Scattered edits, then a dense run that covers whole 64-bit words in order
+		std::vector<IMD::bit_edit> bit_edits;
+		std::vector<IMD::byte_edit> byte_edits;
+		for (size_t i{ 0 }; i < 40; ++i) {
+			bit_edits.push_back({ generator() % n, generator() % 2 == 0 });
+			byte_edits.push_back({ generator() % size, static_cast<std::byte>(generator()) });
+		}
+		for (size_t i{ 0 }; i < std::min<size_t>(n, 200); ++i)
+			bit_edits.push_back({ i, generator() % 3 == 0 });
+
+		result = b;
+		IMD::modify_bits(std::span{ result }, bit_edits);
+		bytes edit_expected{ b };
+		for (auto edit : bit_edits)
+			reference::set(edit_expected, edit.index, edit.value);
+		check(result == edit_expected, "modify_bits", size, name);
+
+		result = b;
+		IMD::modify_bytes(std::span{ result }, byte_edits);
+		edit_expected = b;
+		for (auto edit : byte_edits)
+			edit_expected[edit.index] = static_cast<std::uint8_t>(edit.value);
+		check(result == edit_expected, "modify_bytes", size, name);
+	}
+
+	bytes unpacked(n, 0x55);
+	IMD::unpack_bits(std::span{ b }, std::span{ unpacked });
+	bool unpacked_right{ true };
+	for (size_t i{ 0 }; i < n; ++i)
+		unpacked_right &= unpacked[i] == reference::get(b, i);
+	check(unpacked_right, "unpack_bits", size, name);
+
+	for (size_t i{ 0 }; i < n; ++i)
+		unpacked[i] = static_cast<std::uint8_t>(unpacked[i] * (1 + generator() % 255)); // Any non-zero byte stands for a 1
+	result.assign(size, 0xA5);
+	IMD::pack_bits(std::span{ unpacked }, std::span{ result });
+	check(result == b, "pack_bits", size, name);
+
+	std::vector<std::uint8_t> swapped{ b };
+	IMD::byte_swap(std::span{ swapped });
+	check(std::equal(swapped.begin(), swapped.end(), b.rbegin()), "byte_swap", size, name);
+
+	std::vector<std::uint32_t> elements(size / 4);
+	if (!elements.empty())
+		std::memcpy(elements.data(), b.data(), elements.size() * 4);
+	std::vector<std::uint32_t> big{ elements };
+	IMD::to_big_endian(std::span{ big });
+	bool swapped_right{ true };
+	for (size_t i{ 0 }; i < elements.size(); ++i)
+		swapped_right &= big[i] == (std::endian::native == std::endian::little ? __builtin_bswap32(elements[i]) : elements[i]);
+	check(swapped_right, "to_big_endian", size, name);
+}
+
+// The object overloads for a std::array of <N> bytes, which take the native and the bulk paths of the kernels
+template<size_t N>
+void check_object(pattern kind) {
+	const char* name{ PATTERN_NAMES[static_cast<size_t>(kind)] };
+	bytes b{ make(N, kind) };
+	std::array<std::uint8_t, N> value{};
+	std::copy(b.begin(), b.end(), value.begin());
+	constexpr size_t n{ N * 8 };
+
+	check(IMD::one_bit_count(value) == reference::count(b, 0, n, true), "one_bit_count(object)", N, name);
+	check(IMD::all_bits_zero(value) == (reference::count(b, 0, n, true) == 0), "all_bits_zero(object)", N, name);
+	check(IMD::find_first_set(value) == reference::find_next(b, 0, true), "find_first_set(object)", N, name);
+	check(IMD::countl_zero(value) == reference::run_from_high(b, false), "countl_zero(object)", N, name);
+
+	auto shifted = value;
+	IMD::shift_left_bits(shifted, 13);
+	check(std::equal(shifted.begin(), shifted.end(), reference::shift(b, 13, true).begin()), "shift_left_bits(object)", N, name);
+	shifted = value;
+	IMD::rotate_right_bits(shifted, 77);
+	check(std::equal(shifted.begin(), shifted.end(), reference::rotate(b, 77, false).begin()), "rotate_right_bits(object)", N, name);
+
+	auto swapped = value;
+	IMD::byte_swap(swapped);
+	check(std::equal(swapped.begin(), swapped.end(), b.rbegin()), "byte_swap(object)", N, name);
+
+	std::string text{ IMD::bits_to_string(value, "") };
+	bool text_right{ text.size() == n };
+	for (size_t i{ 0 }; text_right && i < n; ++i)
+		text_right = text[i] == (reference::get(b, i) ? '1' : '0');
+	check(text_right, "bits_to_string(object)", N, name);
+
+	std::array<bool, n> unpacked{};
+	IMD::unpack_bits(value, unpacked.data());
+	bool unpacked_right{ true };
+	for (size_t i{ 0 }; i < n; ++i)
+		unpacked_right &= unpacked[i] == reference::get(b, i);
+	check(unpacked_right, "unpack_bits(object, bool*)", N, name);
+
+	std::array<std::uint8_t, N> packed{};
+	IMD::pack_bits(unpacked.data(), packed);
+	check(packed == value, "pack_bits(bool*, object)", N, name);
+
+	std::array<bool, N> converted{};
+	IMD::bytes_to_container(value, std::span{ converted });
+	bool converted_right{ true };
+	for (size_t i{ 0 }; i < N; ++i)
+		converted_right &= converted[i] == (b[i] != 0);
+	check(converted_right, "bytes_to_container(object, span<bool>)", N, name);
+
+	auto mask = value;
+	for (auto& byte : mask)
+		byte = static_cast<std::uint8_t>(generator());
+	bytes mask_bytes(mask.begin(), mask.end());
+	std::array<std::uint8_t, N> gathered{};
+	IMD::extract_bits(value, mask, gathered);
+	check(std::equal(gathered.begin(), gathered.end(), reference::extract(b, mask_bytes, N).begin()), "extract_bits(object)", N, name);
+	auto scattered = value;
+	IMD::deposit_bits(value, mask, scattered);
+	check(std::equal(scattered.begin(), scattered.end(), reference::deposit(b, mask_bytes, b).begin()), "deposit_bits(object)", N, name);
+}
+
+template<size_t... N>
+void check_objects(std::index_sequence<N...>) {
+	for (size_t kind{ 0 }; kind < PATTERN_NAMES.size(); ++kind)
+		(check_object<N>(static_cast<pattern>(kind)), ...);
+}
+
+int main() {
+	IMD::cpu::report(std::cout);
+
+	std::vector<size_t> sizes;
+	for (size_t size{ 0 }; size <= 1100; ++size)
+		if (size <= 80 || size % 32 <= 1 || size % 32 == 31 || size % 64 <= 1 || size % 64 == 63)
+			sizes.push_back(size);
+	sizes.push_back(4099);
+
+	for (size_t size : sizes) {
+		for (size_t kind{ 0 }; kind < PATTERN_NAMES.size(); ++kind) {
+			const char* name{ PATTERN_NAMES[kind] };
+			bytes first{ make(size, static_cast<pattern>(kind)) };
+			bytes second{ make(size, static_cast<pattern>((kind + 1) % PATTERN_NAMES.size())) };
+			check_queries(first, name);
+			check_transforms(first, second, name);
+			check_transforms(first, make(size, pattern::random), name);
+			check_edits(first, name);
+		}
+
+		// A single bit that differs from all the others, at every position in the short ranges and at some in the long ones
+		size_t n{ size * 8 };
+		for (size_t position{ 0 }; position < n; position += size <= 80 ? 1 : 1 + n / 97) {
+			for (pattern kind : { pattern::zeros, pattern::ones }) {
+				bytes b{ make(size, kind) };
+				reference::set(b, position, kind == pattern::zeros);
+				check_queries(b, kind == pattern::zeros ? "one-hot" : "one-cold");
+			}
+		}
+	}
+
+	check_objects(std::index_sequence<1, 2, 3, 4, 8, 16, 31, 32, 33, 64, 65, 128, 256, 257, 4096>{});
+
+	std::printf("%zu checks, %zu failures\n", checks, failures);
+	return failures == 0 ? 0 : 1;
+}